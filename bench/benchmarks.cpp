@@ -0,0 +1,999 @@
+// Throughput benchmarks. Build the engine_bench target (compiled with
+// optimisation regardless of CMAKE_BUILD_TYPE) and run it, optionally with
+// a substring filter on the group name:
+//
+//     ./engine_bench                 # everything
+//     ./engine_bench replication     # one group
+//
+// Each row reports the best of several repetitions.
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "units.h"
+#include "scaled_quantity.h"
+#include "unit_convert.h"
+#include "dyn_quantity.h"
+#include "quantity_format.h"
+#include "quantity_parse.h"
+#include "ecs.h"
+#include "replication.h"
+#include "quantity_pack.h"
+#include "quantity_vector.h"
+#include "quantity_reduce.h"
+#include "quantity_filter.h"
+#include "quantity_sort.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define BENCH_HAS_PIPE 1
+#endif
+
+namespace bench {
+    // Keep the optimiser from deleting work whose result is otherwise unused
+    template <typename T>
+    inline void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    // Best wall-clock time of `reps` runs, in seconds
+    inline double best_of(int reps, const std::function<void()>& fn) {
+        double best = 1e300;
+        for (int r = 0; r < reps; ++r) {
+            auto t0 = std::chrono::steady_clock::now();
+            fn();
+            double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            if (s < best) best = s;
+        }
+        return best;
+    }
+
+    // One result row; bytes / items of 0 leave that column blank
+    inline void report(const std::string& name, double seconds, double bytes, double items,
+                       const std::string& note = "") {
+        std::printf("  %-44s %10.3f ms", name.c_str(), seconds * 1e3);
+        if (bytes > 0) std::printf("  %8.2f GB/s", bytes / seconds / 1e9);
+        else           std::printf("  %13s", "");
+        if (items > 0) std::printf("  %9.1f M/s", items / seconds / 1e6);
+        else           std::printf("  %11s", "");
+        if (!note.empty()) std::printf("  %s", note.c_str());
+        std::printf("\n");
+    }
+}
+
+// =============================================================================
+// replication — DeltaEncoder / apply_delta throughput and transport
+// =============================================================================
+
+namespace {
+    struct Particle { Length x; Velocity v; };
+
+    void bench_replication() {
+        constexpr int    kCount = 1'000'000;
+        constexpr int    kTicks = 20;
+        const     double raw_bytes = double(kCount) * sizeof(Particle);
+
+        for (double moving : {0.01, 0.10, 1.00}) {
+            ComponentPool<Particle> init;
+            for (int i = 0; i < kCount; ++i) init.assign(i, {Length(i * 0.5), Velocity(1.0 + i % 7)});
+            const int stride = static_cast<int>(1.0 / moving);
+            auto advance = [&](ComponentPool<Particle>& pool, int tick) {
+                for (int i = tick % stride; i < kCount; i += stride)
+                    pool.get(i).x = pool.get(i).x + pool.get(i).v * 0.016_s;
+            };
+
+            // Only the per-tick encode / apply calls are timed; the first
+            // (full-state) message is excluded
+            double enc_s = 1e300, dec_s = 1e300;
+            std::vector<std::byte> stream;
+            size_t first_size = 0;
+            for (int rep = 0; rep < 3; ++rep) {
+                ComponentPool<Particle> src = init;
+                DeltaEncoder<Particle> enc;
+                stream.clear();
+                first_size = enc.encode(src, stream);
+                double t = 0;
+                for (int tick = 0; tick < kTicks; ++tick) {
+                    advance(src, tick);
+                    t += bench::best_of(1, [&] { enc.encode(src, stream); });
+                }
+                enc_s = std::min(enc_s, t);
+            }
+            for (int rep = 0; rep < 3; ++rep) {
+                ComponentPool<Particle> mirror;
+                size_t at = apply_delta(mirror, stream);
+                dec_s = std::min(dec_s, bench::best_of(1, [&] {
+                    while (at < stream.size())
+                        at += apply_delta(mirror, std::span<const std::byte>(stream).subspan(at));
+                }));
+                bench::keep(mirror);
+            }
+
+            char label[64], ratio[64];
+            std::snprintf(label, sizeof label, "%3.0f%% moving, per tick", moving * 100);
+            const double per_tick = double(stream.size() - first_size) / kTicks;
+            std::snprintf(ratio, sizeof ratio, "%.0f B/tick (%.2f%% of raw)", per_tick, 100 * per_tick / raw_bytes);
+            bench::report(std::string("encode, ") + label, enc_s / kTicks, raw_bytes, kCount, ratio);
+            bench::report(std::string("decode, ") + label, dec_s / kTicks, raw_bytes, kCount);
+        }
+
+        // End to end over a transport: encoder thread → bytes → decoder thread
+        ComponentPool<Particle> src;
+        for (int i = 0; i < kCount; ++i) src.assign(i, {Length(i * 0.5), Velocity(1.0)});
+        auto run_ticks = [&](auto&& send) {
+            DeltaEncoder<Particle> enc;
+            std::vector<std::byte> msg;
+            for (int t = 0; t <= kTicks; ++t) {
+                for (int i = t % 10; i < kCount; i += 10) src.get(i).x = src.get(i).x + 1.0_m;
+                msg.clear();
+                enc.encode(src, msg);
+                send(msg);
+            }
+        };
+
+#ifdef BENCH_HAS_PIPE
+        double pipe_s = bench::best_of(3, [&] {
+            int fds[2];
+            if (::pipe(fds) != 0) return;
+            std::thread reader([rd = fds[0]] {
+                ComponentPool<Particle> mirror;
+                std::vector<std::byte> buf;
+                auto read_all = [rd](std::byte* p, size_t n) {
+                    while (n) { ssize_t k = ::read(rd, p, n); if (k <= 0) return false; p += k; n -= size_t(k); }
+                    return true;
+                };
+                std::byte header[sizeof(detail::DeltaHeader)];
+                while (read_all(header, sizeof header)) {
+                    const size_t total = delta_message_size(header);
+                    buf.resize(total);
+                    std::memcpy(buf.data(), header, sizeof header);
+                    if (!read_all(buf.data() + sizeof header, total - sizeof header)) break;
+                    apply_delta(mirror, buf);
+                }
+                ::close(rd);
+                bench::keep(mirror);
+            });
+            run_ticks([wr = fds[1]](const std::vector<std::byte>& msg) {
+                const std::byte* p = msg.data();
+                for (size_t n = msg.size(); n;) { ssize_t k = ::write(wr, p, n); if (k <= 0) return; p += k; n -= size_t(k); }
+            });
+            ::close(fds[1]);
+            reader.join();
+        });
+        bench::report("pipe end-to-end, 10% moving, per tick", pipe_s / (kTicks + 1), raw_bytes, kCount);
+#endif
+
+        const std::string path = "replication_bench.bin";
+        double file_s = bench::best_of(3, [&] {
+            FILE* f = std::fopen(path.c_str(), "wb");
+            if (!f) return;
+            run_ticks([f](const std::vector<std::byte>& msg) { std::fwrite(msg.data(), 1, msg.size(), f); });
+            std::fclose(f);
+
+            f = std::fopen(path.c_str(), "rb");
+            ComponentPool<Particle> mirror;
+            std::vector<std::byte> buf(sizeof(detail::DeltaHeader));
+            while (std::fread(buf.data(), 1, sizeof(detail::DeltaHeader), f) == sizeof(detail::DeltaHeader)) {
+                const size_t total = delta_message_size(buf.data());
+                buf.resize(total);
+                if (std::fread(buf.data() + sizeof(detail::DeltaHeader), 1, total - sizeof(detail::DeltaHeader), f)
+                    != total - sizeof(detail::DeltaHeader)) break;
+                apply_delta(mirror, buf);
+                buf.resize(sizeof(detail::DeltaHeader));
+            }
+            std::fclose(f);
+            bench::keep(mirror);
+        });
+        std::remove(path.c_str());
+        bench::report("file write+replay, 10% moving, per tick", file_s / (kTicks + 1), raw_bytes, kCount);
+    }
+}
+
+// =============================================================================
+// stream — STREAM-style kernels on float vs double quantity arrays
+// =============================================================================
+
+namespace {
+    template <typename Rep>
+    void stream_kernels(const char* rep_name) {
+        using L = RebindRep<Length, Rep>;
+        using V = RebindRep<Velocity, Rep>;
+        using T = RebindRep<Time, Rep>;
+        constexpr size_t kCount = size_t(1) << 24;   // well beyond last-level cache
+        constexpr int    kReps  = 5;
+
+        std::vector<L> a(kCount, L(Rep(1))), b(kCount, L(Rep(2)));
+        std::vector<V> v(kCount, V(Rep(0.5)));
+        const T dt(Rep(0.016));
+        const double n = double(kCount), word = double(sizeof(L));
+
+        auto row = [&](const char* kernel, int words, const std::function<void()>& fn) {
+            bench::report(std::string(kernel) + ", " + rep_name, bench::best_of(kReps, fn), n * words * word, n);
+        };
+        row("copy   a = b", 2, [&] {
+            for (size_t i = 0; i < kCount; ++i) a[i] = b[i];
+            bench::keep(a);
+        });
+        row("scale  a = 2 b", 2, [&] {
+            for (size_t i = 0; i < kCount; ++i) a[i] = b[i] * Rep(2);
+            bench::keep(a);
+        });
+        row("add    a = a + b", 3, [&] {
+            for (size_t i = 0; i < kCount; ++i) a[i] = a[i] + b[i];
+            bench::keep(a);
+        });
+        row("triad  a = b + v dt", 3, [&] {
+            for (size_t i = 0; i < kCount; ++i) a[i] = b[i] + v[i] * dt;
+            bench::keep(a);
+        });
+    }
+
+    void bench_stream() {
+        stream_kernels<double>("double");
+        stream_kernels<float>("float");
+    }
+}
+
+// =============================================================================
+// simd — scalar Quantity loops vs QuantityPack at native width
+// =============================================================================
+
+namespace {
+    void bench_simd() {
+        constexpr size_t kCount = size_t(1) << 16;   // L2-resident, so compute is what's measured
+        constexpr int    kReps  = 200;
+        constexpr int    N      = simd::kNativeLanes<double>;
+        using AccelPack = QuantityPack<Acceleration::DimensionType, N>;
+
+        std::vector<Velocity> vx, vy;
+        std::vector<Time>     dt;
+        for (size_t i = 0; i < kCount; ++i) {
+            vx.push_back(Velocity(1.0 + i % 13));
+            vy.push_back(Velocity(2.0 - i % 7));
+            dt.push_back(Time(0.01 + 1e-4 * (i % 5)));
+        }
+        std::vector<Acceleration> out(kCount, Acceleration(0.0));
+        const double n = double(kCount), bytes = n * 4 * sizeof(double);
+        const std::string note = std::to_string(N) + " lanes";
+
+        // |v| / dt — one sqrt, one divide per element
+        bench::report("scalar  |v| / dt", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i)
+                out[i] = sqrt(vx[i] * vx[i] + vy[i] * vy[i]) / dt[i];
+            bench::keep(out);
+        }), bytes, n);
+        bench::report("pack    |v| / dt", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; i += N) {
+                auto x = load_pack<N>(&vx[i]);
+                auto y = load_pack<N>(&vy[i]);
+                AccelPack a = sqrt(x * x + y * y) / load_pack<N>(&dt[i]);
+                store_pack(a, &out[i]);
+            }
+            bench::keep(out);
+        }), bytes, n, note);
+    }
+}
+
+// =============================================================================
+// vector — QuantityVector kernels vs naive loops, 1K to 100M elements
+// =============================================================================
+
+namespace {
+    void bench_vector() {
+        for (size_t n : {size_t(1'000), size_t(100'000), size_t(10'000'000), size_t(100'000'000)}) {
+            const int reps = static_cast<int>(std::clamp<size_t>(100'000'000 / n, 3, 2000));
+            QuantityVector<Length::DimensionType> x(n, 3.0_m);
+            QuantityVector<Time::DimensionType>   t(n, 2.0_s);
+            for (size_t i = 0; i < n; i += 7) x[i] = Length(1.0 + i % 11);
+            const double bytes = 3.0 * n * sizeof(double);
+            char size[32];
+            std::snprintf(size, sizeof size, "n=%zu", n);
+
+            // The naive loop builds its result the way hand-written code does today
+            bench::report(std::string("naive   v = x / t, ") + size, bench::best_of(reps, [&] {
+                std::vector<Velocity> v;
+                v.reserve(n);
+                for (size_t i = 0; i < n; ++i) v.push_back(x[i] / t[i]);
+                bench::keep(v);
+            }), bytes, double(n));
+            bench::report(std::string("vector  v = x / t, ") + size, bench::best_of(reps, [&] {
+                QuantityVector v = x / t;
+                bench::keep(v);
+            }), bytes, double(n));
+
+            bench::report(std::string("naive   sqrt(x * x), ") + size, bench::best_of(reps, [&] {
+                std::vector<Length> r;
+                r.reserve(n);
+                for (size_t i = 0; i < n; ++i) r.push_back(sqrt(x[i] * x[i]));
+                bench::keep(r);
+            }), 2.0 * n * sizeof(double), double(n));
+            bench::report(std::string("vector  sqrt(x * x), ") + size, bench::best_of(reps, [&] {
+                QuantityVector r = sqrt(x * x);
+                bench::keep(r);
+            }), 2.0 * n * sizeof(double), double(n));
+        }
+    }
+}
+
+// =============================================================================
+// expr — fused expression templates vs one temporary per operator
+// =============================================================================
+
+namespace {
+    void bench_expr() {
+        constexpr size_t kCount = 10'000'000;
+        constexpr int    kReps  = 5;
+        using MassV  = QuantityVector<Mass::DimensionType>;
+        using VelV   = QuantityVector<Velocity::DimensionType>;
+        using LenV   = QuantityVector<Length::DimensionType>;
+        using EnergyV = QuantityVector<Energy::DimensionType>;
+
+        MassV m(kCount, 2.0_kg);
+        VelV  v(kCount, Velocity(3.0));
+        LenV  h(kCount, 10.0_m);
+        for (size_t i = 0; i < kCount; i += 3) v[i] = Velocity(1.0 + i % 17);
+        const Acceleration g(9.81);
+        EnergyV e(kCount);
+        const double n = double(kCount);
+
+        // Kinetic energy: 0.5 m v²  — fused traffic is 2 reads + 1 write
+        const double ke_bytes = 3 * n * sizeof(double);
+        bench::report("naive loop   0.5 m v^2", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) e[i] = 0.5 * m[i] * v[i] * v[i];
+            bench::keep(e);
+        }), ke_bytes, n);
+        bench::report("per-operator 0.5 m v^2", bench::best_of(kReps, [&] {
+            QuantityVector<Mass::DimensionType> half_m = 0.5 * m;
+            QuantityVector<Dimensions<0, 2, -2>> v2 = pow<2>(v);
+            e = half_m * v2;
+            bench::keep(e);
+        }), ke_bytes, n, "2 temporaries");
+        bench::report("fused        0.5 m v^2", bench::best_of(kReps, [&] {
+            e = 0.5 * m * pow<2>(v);
+            bench::keep(e);
+        }), ke_bytes, n);
+
+        // Mechanical energy: 0.5 m v² + m g h  — 3 reads + 1 write fused
+        const double me_bytes = 4 * n * sizeof(double);
+        bench::report("naive loop   0.5 m v^2 + m g h", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) e[i] = 0.5 * m[i] * v[i] * v[i] + m[i] * g * h[i];
+            bench::keep(e);
+        }), me_bytes, n);
+        bench::report("per-operator 0.5 m v^2 + m g h", bench::best_of(kReps, [&] {
+            MassV   half_m = 0.5 * m;
+            QuantityVector<Dimensions<0, 2, -2>> v2 = pow<2>(v);
+            EnergyV ke = half_m * v2;
+            QuantityVector<Force::DimensionType> w = m * g;
+            EnergyV pe = w * h;
+            e = ke + pe;
+            bench::keep(e);
+        }), me_bytes, n, "5 temporaries");
+        bench::report("fused        0.5 m v^2 + m g h", bench::best_of(kReps, [&] {
+            e = 0.5 * m * pow<2>(v) + m * g * h;
+            bench::keep(e);
+        }), me_bytes, n);
+    }
+}
+
+// =============================================================================
+// pow — pow<N> multiplication chains vs std::pow, N = 2..8
+// =============================================================================
+
+namespace {
+    template <int N>
+    void pow_row(const std::vector<Length>& x, std::vector<double>& out) {
+        constexpr int kReps = 20;
+        const double n = double(x.size()), bytes = 2 * n * sizeof(double);
+        char name[48];
+        std::snprintf(name, sizeof name, "std::pow(x, %d)", N);
+        bench::report(name, bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < x.size(); ++i) out[i] = std::pow(x[i].value, N);
+            bench::keep(out);
+        }), bytes, n);
+        std::snprintf(name, sizeof name, "pow<%d>(x)", N);
+        bench::report(name, bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < x.size(); ++i) out[i] = pow<N>(x[i]).value;
+            bench::keep(out);
+        }), bytes, n, std::to_string(detail::chain_cost(N)) + " multiplies");
+    }
+
+    void bench_pow() {
+        constexpr size_t kCount = size_t(1) << 18;   // cache-resident
+        std::vector<Length> x;
+        for (size_t i = 0; i < kCount; ++i) x.push_back(Length(0.5 + 1e-6 * double(i)));
+        std::vector<double> out(kCount);
+        [&]<int... N>(std::integer_sequence<int, N...>) {
+            (pow_row<N + 2>(x, out), ...);
+        }(std::make_integer_sequence<int, 7>{});
+    }
+}
+
+// =============================================================================
+// fma — fused primitives vs the operator chains they replace
+// =============================================================================
+
+namespace {
+    void bench_fma() {
+        constexpr size_t kCount = size_t(1) << 18;   // cache-resident
+        constexpr int    kReps  = 20;
+        std::vector<Length> x, y, out(kCount, Length(0.0));
+        std::vector<Velocity> v;
+        for (size_t i = 0; i < kCount; ++i) {
+            x.push_back(Length(1.0 + 1e-6 * double(i)));
+            y.push_back(Length(2.0 - 1e-6 * double(i)));
+            v.push_back(Velocity(0.25 + 1e-7 * double(i)));
+        }
+        const Time   dt(1.0 / 60.0);
+        const double n = double(kCount), bytes3 = 3 * n * sizeof(double);
+        const char*  fused = detail::kFastFma ? "hardware fma" : "no fast fma: a*b+c";
+
+        bench::report("x + v * dt", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = x[i] + v[i] * dt;
+            bench::keep(out);
+        }), bytes3, n);
+        bench::report("fma(v, dt, x)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = fma(v[i], dt, x[i]);
+            bench::keep(out);
+        }), bytes3, n, fused);
+        bench::report("sqrt(x * x + y * y)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = sqrt(x[i] * x[i] + y[i] * y[i]);
+            bench::keep(out);
+        }), bytes3, n, "unsafe near overflow");
+        bench::report("std::hypot(x, y)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = Length(std::hypot(x[i].value, y[i].value));
+            bench::keep(out);
+        }), bytes3, n);
+        bench::report("hypot(x, y)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = hypot(x[i], y[i]);
+            bench::keep(out);
+        }), bytes3, n);
+        bench::report("x + 0.3 * (y - x)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = x[i] + 0.3 * (y[i] - x[i]);
+            bench::keep(out);
+        }), bytes3, n);
+        bench::report("lerp(x, y, 0.3)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = lerp(x[i], y[i], 0.3);
+            bench::keep(out);
+        }), bytes3, n);
+        bench::report("midpoint(x, y)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = midpoint(x[i], y[i]);
+            bench::keep(out);
+        }), bytes3, n);
+    }
+}
+
+// =============================================================================
+// scaled — ScaledQuantity folded conversion factors vs per-hop conversion
+// =============================================================================
+
+namespace {
+    void bench_scaled() {
+        constexpr size_t kCount = size_t(1) << 18;   // cache-resident
+        constexpr int    kReps  = 20;
+        std::vector<double> a, b;
+        for (size_t i = 0; i < kCount; ++i) {
+            a.push_back(1.0 + 1e-6 * double(i));
+            b.push_back(2.0 - 1e-6 * double(i));
+        }
+        std::vector<Length>   len(kCount, Length(0.0));
+        std::vector<Area>     area(kCount, Area(0.0));
+        std::vector<Velocity> vel(kCount, Velocity(0.0));
+        const double n = double(kCount), bytes2 = 2 * n * sizeof(double), bytes3 = 3 * n * sizeof(double);
+
+        // Feet → inches → metres: each hop a runtime factor, or one folded constant
+        bench::report("ft: (a * 12) * 0.0254", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) len[i] = Length((a[i] * 12.0) * 0.0254);
+            bench::keep(len);
+        }), bytes2, n, "2 multiplies");
+        bench::report("ft: Length(Feet(a))", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) len[i] = Feet(a[i]);
+            bench::keep(len);
+        }), bytes2, n, "1 multiply");
+
+        // ft × ft → m²: convert each operand, or multiply in ft² and scale once
+        bench::report("a_ft * b_ft, operands to SI", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) area[i] = Length(a[i] * 0.3048) * Length(b[i] * 0.3048);
+            bench::keep(area);
+        }), bytes3, n, "3 multiplies");
+        bench::report("Feet(a) * Feet(b)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) area[i] = Feet(a[i]) * Feet(b[i]);
+            bench::keep(area);
+        }), bytes3, n, "2 multiplies");
+
+        // mi / h → m/s
+        bench::report("mi / h, operands to SI", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) vel[i] = Length(a[i] * 1609.344) / Time(b[i] * 3600.0);
+            bench::keep(vel);
+        }), bytes3, n, "2 multiplies + divide");
+        bench::report("Miles(a) / Hours(b)", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) vel[i] = Miles(a[i]) / Hours(b[i]);
+            bench::keep(vel);
+        }), bytes3, n, "1 multiply + divide");
+
+        // Totals: convert every sample, or sum in feet and convert the sum
+        bench::report("sum of Length(a * 0.3048)", bench::best_of(kReps, [&] {
+            Length s(0.0);
+            for (size_t i = 0; i < kCount; ++i) s = s + Length(a[i] * 0.3048);
+            len[0] = s;
+            bench::keep(len);
+        }), n * sizeof(double), n);
+        bench::report("Length(sum of Feet(a))", bench::best_of(kReps, [&] {
+            Feet s(0.0);
+            for (size_t i = 0; i < kCount; ++i) s = s + Feet(a[i]);
+            len[0] = s;
+            bench::keep(len);
+        }), n * sizeof(double), n);
+    }
+}
+
+// =============================================================================
+// convert — bulk convert<Unit> of raw readings vs scalar ingest loops
+// =============================================================================
+
+namespace {
+    // One unit: the loop ingest code writes today, then the bulk kernel
+    template <typename U>
+    void bench_convert_unit(const char* name, const std::vector<double>& raw, int reps) {
+        using Q = typename U::quantity;
+        const size_t n = raw.size();
+        const double bytes = 2.0 * n * sizeof(double);
+        std::vector<Q> out(n, Q(0.0));
+        char label[64];
+
+        std::snprintf(label, sizeof label, "%-5s push_back loop, n=%zu", name, n);
+        bench::report(label, bench::best_of(reps, [&] {
+            std::vector<Q> v;
+            v.reserve(n);
+            for (double x : raw) v.push_back(Q(x * U::factor + U::offset));
+            bench::keep(v);
+        }), bytes, double(n));
+        std::snprintf(label, sizeof label, "%-5s convert<U>(raw), n=%zu", name, n);
+        bench::report(label, bench::best_of(reps, [&] {
+            auto v = convert<U>(raw);
+            bench::keep(v);
+        }), bytes, double(n));
+        std::snprintf(label, sizeof label, "%-5s scalar loop into out, n=%zu", name, n);
+        bench::report(label, bench::best_of(reps, [&] {
+            for (size_t i = 0; i < n; ++i) out[i] = Q(raw[i] * U::factor + U::offset);
+            bench::keep(out);
+        }), bytes, double(n));
+        std::snprintf(label, sizeof label, "%-5s convert<U>(raw, out), n=%zu", name, n);
+        bench::report(label, bench::best_of(reps, [&] {
+            convert<U>(raw, out);
+            bench::keep(out);
+        }), bytes, double(n));
+    }
+
+    void bench_convert() {
+        for (size_t n : {size_t(1) << 16, size_t(1) << 24}) {
+            const int reps = static_cast<int>(std::clamp<size_t>(200'000'000 / n, 5, 2000));
+            std::vector<double> raw(n);
+            for (size_t i = 0; i < n; ++i) raw[i] = 10.0 + 1e-4 * double(i % 100'000);
+            bench_convert_unit<unit::psi>("psi", raw, reps);
+            bench_convert_unit<unit::degF>("degF", raw, reps);
+            bench_convert_unit<unit::ft>("ft", raw, reps);
+            bench_convert_unit<unit::lb>("lb", raw, reps);
+        }
+    }
+}
+
+// =============================================================================
+// print — text output of quantities
+// =============================================================================
+
+namespace {
+    void bench_print() {
+        constexpr size_t kCount = size_t(1) << 18;
+        constexpr int    kReps  = 10;
+        std::vector<Energy>   e;
+        std::vector<Velocity> v;
+        for (size_t i = 0; i < kCount; ++i) {
+            e.push_back(Energy(1.0 + 1e-3 * double(i)));
+            v.push_back(Velocity(0.25 * double(i % 1000)));
+        }
+        std::ostringstream os;
+        const double n = double(kCount);
+
+        auto run = [&](const char* name, auto& values) {
+            size_t chars = 0;
+            const double t = bench::best_of(kReps, [&] {
+                os.str("");
+                for (const auto& q : values) os << q << '\n';
+                chars = size_t(os.tellp());
+                bench::keep(os);
+            });
+            bench::report(name, t, double(chars), n);
+        };
+        run("os << Energy", e);
+        run("os << Velocity", v);
+        std::vector<NamedQuantity<Energy>> ne;
+        for (const auto& q : e) ne.push_back(named(q));
+        run("os << named(Energy)", ne);
+
+        // The same text without a stream: snprintf, and to_chars with the
+        // compile-time suffix, both into one preallocated buffer
+        std::vector<char> text(kCount * 64);
+        size_t chars = 0;
+        const double t_printf = bench::best_of(kReps, [&] {
+            char* p = text.data();
+            for (const auto& q : e) p += std::snprintf(p, 64, "%g [kg\xc2\xb7m^2\xc2\xb7s^-2]\n", q.value);
+            chars = size_t(p - text.data());
+            bench::keep(text);
+        });
+        bench::report("snprintf(\"%g [unit]\") Energy", t_printf, double(chars), n);
+        const double t_chars = bench::best_of(kReps, [&] {
+            char* p = text.data();
+            for (const auto& q : e) {
+                p    = to_chars(p, p + 64, q).ptr;
+                *p++ = '\n';
+            }
+            chars = size_t(p - text.data());
+            bench::keep(text);
+        });
+        bench::report("to_chars Energy", t_chars, double(chars), n, "shortest round-trip");
+        const double t_chars6 = bench::best_of(kReps, [&] {
+            char* p = text.data();
+            for (const auto& q : e) {
+                p    = to_chars(p, p + 64, q, {'g', 6}).ptr;
+                *p++ = '\n';
+            }
+            chars = size_t(p - text.data());
+            bench::keep(text);
+        });
+        bench::report("to_chars Energy {'g', 6}", t_chars6, double(chars), n, "same digits as os <<");
+        const double t_named = bench::best_of(kReps, [&] {
+            char* p = text.data();
+            for (const auto& q : e) {
+                p    = to_chars(p, p + 64, q, {0, -1, true}).ptr;
+                *p++ = '\n';
+            }
+            chars = size_t(p - text.data());
+            bench::keep(text);
+        });
+        bench::report("to_chars Energy, named", t_named, double(chars), n, "\"[J]\"");
+    }
+}
+
+// =============================================================================
+// parse — text to quantities
+// =============================================================================
+
+namespace {
+    void bench_parse() {
+        // Lines of mixed units; "tokens" counts the number, each symbol, each
+        // separator or bracket and each exponent
+        struct Sample { const char* text; int tokens; };
+        constexpr Sample kSamples[] = {
+            {"9.81 m/s^2", 5}, {"3 kWh", 2}, {"101.3 kPa", 2}, {"72 degF", 2},
+            {"1.2e3 N\xc2\xb7m", 4}, {"60 mi/hr", 4}, {"4186 J/(kg\xc2\xb7K)", 8},
+            {"2.5 [kg\xc2\xb7m^2\xc2\xb7s^-2]", 10},
+        };
+        constexpr size_t kCount = size_t(1) << 20;
+        constexpr int    kReps  = 10;
+
+        std::string mixed, numbers, pressures;
+        double tokens = 0;
+        for (size_t i = 0; i < kCount; ++i) {
+            const Sample& s = kSamples[i % std::size(kSamples)];
+            mixed += s.text;
+            mixed += '\n';
+            tokens += s.tokens;
+            numbers += std::string_view(s.text).substr(0, std::string_view(s.text).find(' '));
+            numbers += '\n';
+            pressures += i % 2 ? "101.3 kPa\n" : "14.7 psi\n";
+        }
+        const double n = double(kCount);
+
+        // Every line is one quantity; a failure would stop the loop early
+        auto parse_all = [&](const std::string& text, auto& out) {
+            double sum = 0;
+            const char* p    = text.data();
+            const char* last = p + text.size();
+            while (p < last) {
+                const auto r = parse_quantity(p, last, out);
+                if (r.ec != std::errc()) break;
+                sum += out.value;
+                p = r.ptr + 1;
+            }
+            return sum;
+        };
+
+        const double t_numbers = bench::best_of(kReps, [&] {
+            double v = 0, sum = 0;
+            const char* p    = numbers.data();
+            const char* last = p + numbers.size();
+            while (p < last) {
+                p = std::from_chars(p, last, v).ptr + 1;
+                sum += v;
+            }
+            bench::keep(sum);
+        });
+        bench::report("std::from_chars, numbers only", t_numbers, double(numbers.size()), n, "lower bound");
+
+        DynQuantity q{};
+        const double t_mixed = bench::best_of(kReps, [&] { bench::keep(parse_all(mixed, q)); });
+        char note[64];
+        std::snprintf(note, sizeof note, "%.1f M tokens/s", tokens / t_mixed / 1e6);
+        bench::report("parse_quantity, mixed units", t_mixed, double(mixed.size()), n, note);
+
+        Pressure pa(0.0);
+        const double t_typed = bench::best_of(kReps, [&] { bench::keep(parse_all(pressures, pa)); });
+        bench::report("parse_quantity<Pressure>, kPa / psi", t_typed, double(pressures.size()), n, "dimension checked");
+    }
+}
+
+// =============================================================================
+// dyn — arithmetic on run-time dimensions
+// =============================================================================
+
+namespace {
+    void bench_dyn() {
+        constexpr size_t kCount = size_t(1) << 16;   // cache-resident
+        constexpr int    kReps  = 20;
+        std::vector<double> m, v, t, out(kCount);
+        std::vector<Mass> tm;
+        std::vector<Velocity> tv;
+        std::vector<Time> tt;
+        std::vector<DynQuantity> dm, dv, dt, dout(kCount);
+        for (size_t i = 0; i < kCount; ++i) {
+            m.push_back(1.0 + 1e-6 * double(i));
+            v.push_back(0.25 + 1e-7 * double(i));
+            t.push_back(2.0 - 1e-6 * double(i));
+            tm.push_back(Mass(m.back()));
+            tv.push_back(Velocity(v.back()));
+            tt.push_back(Time(t.back()));
+            dm.push_back(tm.back());
+            dv.push_back(tv.back());
+            dt.push_back(tt.back());
+        }
+        // Power = 0.5 · m · v · v / t: four dimensioned operations per element
+        const double n = double(kCount), ops = 4 * n;
+        char note[64];
+        auto report = [&](const char* name, double seconds, const char* what) {
+            std::snprintf(note, sizeof note, "%.0f M dimensioned ops/s; %s", ops / seconds / 1e6, what);
+            bench::report(name, seconds, 0, n, note);
+        };
+
+        report("double: 0.5 * m * v * v / t", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = 0.5 * m[i] * v[i] * v[i] / t[i];
+            bench::keep(out);
+        }), "no dimensions");
+        report("Quantity: 0.5 * m * v * v / t", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = Power(0.5 * tm[i] * tv[i] * tv[i] / tt[i]).value;
+            bench::keep(out);
+        }), "checked at compile time");
+        report("DynQuantity: 0.5 * m * v * v / t", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) dout[i] = 0.5 * dm[i] * dv[i] * dv[i] / dt[i];
+            bench::keep(dout);
+        }), "codes carried");
+        report("DynQuantity, then as<Power>()", bench::best_of(kReps, [&] {
+            for (size_t i = 0; i < kCount; ++i) out[i] = (0.5 * dm[i] * dv[i] * dv[i] / dt[i]).as<Power>().value;
+            bench::keep(out);
+        }), "checked per element");
+
+        const double t_sum = bench::best_of(kReps, [&] {
+            double sum = 0;
+            for (size_t i = 0; i < kCount; ++i) sum += m[i];
+            bench::keep(sum);
+        });
+        bench::report("double sum", t_sum, n * sizeof(double), n);
+        const double t_dsum = bench::best_of(kReps, [&] {
+            DynQuantity sum = 0.0_kg;
+            for (size_t i = 0; i < kCount; ++i) sum = sum + dm[i];
+            bench::keep(sum);
+        });
+        bench::report("DynQuantity sum", t_dsum, n * sizeof(DynQuantity), n, "one code compare per add");
+    }
+}
+
+// =============================================================================
+// reduce — sum, min, dot and variance over Energy columns
+// =============================================================================
+
+namespace {
+    void bench_reduce() {
+        for (size_t count : {size_t(1) << 16, size_t(1) << 24}) {
+            const int reps = count < (size_t(1) << 20) ? 200 : 5;
+            std::vector<Energy> e(count, Energy(0.0));
+            std::vector<Length> x(count, Length(0.0));
+            long double exact = 0;
+            for (size_t i = 0; i < count; ++i) {
+                // Magnitudes spread over six decades, so rounding shows
+                e[i] = Energy(std::pow(10.0, double(i % 61) / 10.0) * (1.0 + 1e-3 * double(i % 997)));
+                x[i] = Length(1.0 + 1e-6 * double(i));
+                exact += e[i].value;
+            }
+            const double n = double(count), bytes = n * sizeof(Energy);
+            std::printf(" %zu elements\n", count);
+            char note[64];
+            auto error_note = [&](double got) {
+                std::snprintf(note, sizeof note, "rel. error %.1e", double(std::abs((got - exact) / exact)));
+                return std::string(note);
+            };
+
+            double r = 0;
+            double t = bench::best_of(reps, [&] {
+                double acc = 0;
+                for (size_t i = 0; i < count; ++i) acc += e[i].value;
+                r = acc;
+                bench::keep(r);
+            });
+            bench::report("loop: acc += e[i]", t, bytes, n, error_note(r));
+            t = bench::best_of(reps, [&] { r = sum(e).value; bench::keep(r); });
+            bench::report("sum(e), pairwise", t, bytes, n, error_note(r));
+            t = bench::best_of(reps, [&] { r = sum(e, {.summation = Summation::kahan}).value; bench::keep(r); });
+            bench::report("sum(e), kahan", t, bytes, n, error_note(r));
+            const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+            t = bench::best_of(reps, [&] { r = sum(e, {.threads = 0}).value; bench::keep(r); });
+            std::snprintf(note, sizeof note, "%u threads", hw);
+            bench::report("sum(e), pairwise, one thread per core", t, bytes, n, note);
+            t = bench::best_of(reps, [&] { r = min(e).value; bench::keep(r); });
+            bench::report("min(e)", t, bytes, n);
+            t = bench::best_of(reps, [&] { r = dot(e, x).value; bench::keep(r); });
+            bench::report("dot(e, x)", t, 2 * bytes, n);
+            t = bench::best_of(reps, [&] { r = variance(e).value; bench::keep(r); });
+            bench::report("variance(e)", t, 2 * bytes, n, "two passes");
+        }
+    }
+}
+
+// =============================================================================
+// filter — temperature > threshold at several selectivities
+// =============================================================================
+
+namespace {
+    void bench_filter() {
+        constexpr size_t kCount = size_t(1) << 24;
+        constexpr int    kReps  = 5;
+        // Uniform in [250, 450) K from a fixed LCG, so a threshold sets the selectivity
+        std::vector<Temperature> t(kCount, Temperature(0.0));
+        std::uint64_t state = 12345;
+        for (auto& x : t) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            x = Temperature(250.0 + 200.0 * double(state >> 11) * 0x1.0p-53);
+        }
+        std::vector<std::uint32_t> idx(kCount);
+        std::vector<std::uint64_t> bits(bitmap_words(kCount));
+        const double n = double(kCount), bytes = n * sizeof(Temperature);
+        for (double selectivity : {0.001, 0.01, 0.1, 0.5, 0.9}) {
+            const Temperature limit(450.0 - 200.0 * selectivity);
+            std::printf(" t > %.1f K, %g%% selected\n", limit.value, selectivity * 100);
+            size_t found = 0;
+            char note[64];
+            auto matches = [&] {
+                std::snprintf(note, sizeof note, "%zu matches", found);
+                return std::string(note);
+            };
+
+            double s = bench::best_of(kReps, [&] {
+                size_t k = 0;
+                for (size_t i = 0; i < kCount; ++i)
+                    if (t[i] > limit) idx[k++] = std::uint32_t(i);
+                found = k;
+                bench::keep(idx);
+            });
+            bench::report("scalar branch", s, bytes, n, matches());
+            s = bench::best_of(kReps, [&] {
+                size_t k = 0;
+                for (size_t i = 0; i < kCount; ++i) {
+                    idx[k] = std::uint32_t(i);
+                    k += t[i] > limit;
+                }
+                found = k;
+                bench::keep(idx);
+            });
+            bench::report("scalar, branch-free", s, bytes, n, matches());
+            s = bench::best_of(kReps, [&] {
+                found = select_indices(t, std::greater<>{}, limit, std::span(idx));
+                bench::keep(idx);
+            });
+            bench::report("select_indices into existing storage", s, bytes, n, matches());
+            s = bench::best_of(kReps, [&] {
+                auto v = select_indices(t, std::greater<>{}, limit);
+                found = v.size();
+                bench::keep(v);
+            });
+            bench::report("select_indices, new vector", s, bytes, n, matches());
+            s = bench::best_of(kReps, [&] {
+                select_bitmap(t, std::greater<>{}, limit, std::span(bits));
+                bench::keep(bits);
+            });
+            bench::report("select_bitmap into existing storage", s, bytes, n);
+        }
+    }
+}
+
+// =============================================================================
+// sort — std::sort against radix_sort, keys only and with ids, by thread count
+// =============================================================================
+
+namespace {
+    void bench_sort() {
+        for (size_t count : {size_t(1) << 20, size_t(1) << 24}) {
+            const int reps = count < (size_t(1) << 22) ? 10 : 3;
+            std::vector<Time> input(count, Time(0.0)), work(count, Time(0.0));
+            std::uint64_t state = 99;
+            for (auto& t : input) {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                t = Time((double(state >> 11) * 0x1.0p-53 - 0.25) * 1e4);
+            }
+            std::vector<std::uint32_t> ids(count), ids_work(count);
+            std::iota(ids.begin(), ids.end(), 0u);
+            std::vector<std::pair<Time, std::uint32_t>> pairs;
+            for (size_t i = 0; i < count; ++i) pairs.emplace_back(input[i], ids[i]);
+            auto pairs_work = pairs;
+
+            // Every row restores the unsorted input first; that copy is timed
+            // separately and subtracted
+            const double copy = bench::best_of(reps, [&] { work = input; ids_work = ids; bench::keep(work); });
+            const double n = double(count), bytes = n * sizeof(Time);
+            std::printf(" %zu elements\n", count);
+            auto row = [&](const std::string& name, const std::function<void()>& sort, const std::string& note = "") {
+                const double t = bench::best_of(reps, [&] { work = input; ids_work = ids; sort(); bench::keep(work); });
+                bench::report(name, std::max(t - copy, 1e-9), bytes, n, note);
+            };
+
+            row("std::sort", [&] { std::sort(work.begin(), work.end()); });
+            row("radix_sort", [&] { radix_sort(work); });
+            const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned threads : {2u, 4u, hw}) {
+                if (threads == hw && threads <= 4) continue;
+                row("radix_sort, " + std::to_string(threads) + " threads",
+                    [&] { radix_sort(work, {.threads = threads}); });
+            }
+            row("radix_sort, one thread per core", [&] { radix_sort(work, {.threads = 0}); },
+                std::to_string(hw) + " hardware threads");
+
+            const double pair_copy = bench::best_of(reps, [&] { pairs_work = pairs; bench::keep(pairs_work); });
+            const double t_pairs = bench::best_of(reps, [&] {
+                pairs_work = pairs;
+                std::sort(pairs_work.begin(), pairs_work.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+                bench::keep(pairs_work);
+            });
+            bench::report("std::sort of (Time, id) pairs", std::max(t_pairs - pair_copy, 1e-9), bytes, n);
+            row("radix_sort(keys, ids)", [&] { radix_sort(work, ids_work); });
+        }
+    }
+}
+
+// =============================================================================
+
+int main(int argc, char** argv) {
+    const std::string filter = argc > 1 ? argv[1] : "";
+    const std::pair<const char*, void (*)()> groups[] = {
+        {"replication", bench_replication},
+        {"stream",      bench_stream},
+        {"simd",        bench_simd},
+        {"vector",      bench_vector},
+        {"expr",        bench_expr},
+        {"pow",         bench_pow},
+        {"fma",         bench_fma},
+        {"scaled",      bench_scaled},
+        {"convert",     bench_convert},
+        {"print",       bench_print},
+        {"parse",       bench_parse},
+        {"dyn",         bench_dyn},
+        {"reduce",      bench_reduce},
+        {"filter",      bench_filter},
+        {"sort",        bench_sort},
+    };
+    for (const auto& [name, fn] : groups) {
+        if (!filter.empty() && std::string(name).find(filter) == std::string::npos) continue;
+        std::printf("%s\n", name);
+        fn();
+    }
+    return 0;
+}
@@ -0,0 +1,44 @@
+// Compile-time stress translation unit for bench/compile_time.sh.
+//
+// Instantiates quantity arithmetic over a few hundred distinct dimensions —
+// products, quotients, sums, pow and sqrt — so that compile time, object size
+// and symbol length are dominated by the dimension machinery in dimensions.h
+// rather than by anything else. It is not built by CMake; the script
+// compiles and links it directly.
+#include <cstdio>
+#include <utility>
+#include "dimensions.h"
+
+namespace {
+    constexpr int kDims = 24;
+
+    // kDims distinct dimensions with exponents in -2..2
+    template <int I>
+    using D = Dimensions<I % 5 - 2, I / 5 % 5 - 2, I * 7 % 5 - 2, I % 3 - 1, I % 2>;
+
+    template <int I, int J>
+    [[gnu::noinline]] double formula(double x) {
+        Quantity<D<I>> a(x);
+        Quantity<D<J>> b(x + 1.0);
+        auto p = a * b;
+        auto q = p / b;                      // back to D<I>
+        auto r = pow<2>(a) / (a * a) * b;    // back to D<J>
+        auto s = sqrt(pow<2>(p) * pow<-2>(b)); // back to D<I>
+        return (q + s).value + (r - b).value + (a / p * p).value;
+    }
+
+    template <int I, int... J>
+    double row(double x, std::integer_sequence<int, J...>) {
+        return (formula<I, J>(x) + ...);
+    }
+
+    template <int... I>
+    double all(double x, std::integer_sequence<int, I...>) {
+        return (row<I>(x, std::make_integer_sequence<int, kDims>{}) + ...);
+    }
+}
+
+int main(int argc, char**) {
+    std::printf("%g\n", all(double(argc), std::make_integer_sequence<int, kDims>{}));
+    return 0;
+}
@@ -0,0 +1,53 @@
+#!/bin/sh
+# Compile-time benchmark: best-of-N wall time to compile tests/unit_tests.cpp
+# and bench/compile_stress.cpp, plus the stress object's size, longest
+# symbol and link time, with and without debug info. Run from the repository
+# root after configuring the CMake build (for the GoogleTest headers):
+#
+#     bench/compile_time.sh [build-dir] [reps]
+#
+# Compare numbers from the same machine before and after a change to the
+# dimension machinery.
+set -eu
+build=${1:-build}
+reps=${2:-3}
+cxx=${CXX:-c++}
+gtest=$(sed -n 's/^FETCHCONTENT_SOURCE_DIR_GOOGLETEST:PATH=//p' "$build/CMakeCache.txt")
+[ -n "$gtest" ] || gtest="$build/_deps/googletest-src"
+tmp=$(mktemp -d)
+trap 'rm -rf "$tmp"' EXIT
+
+# best <reps> <command...> — prints the best wall time in seconds
+best() {
+    n=$1; shift
+    b=""
+    i=0
+    while [ "$i" -lt "$n" ]; do
+        s=$(date +%s.%N)
+        "$@"
+        e=$(date +%s.%N)
+        b=$(awk -v s="$s" -v e="$e" -v b="$b" 'BEGIN { t = e - s; print (b == "" || t < b) ? t : b }')
+        i=$((i + 1))
+    done
+    printf '%.2f' "$b"
+}
+
+flags="-std=gnu++20 -Wno-psabi -Iinclude"
+t_tests=$(best "$reps" $cxx $flags -isystem "$gtest/googletest/include" -c tests/unit_tests.cpp -o "$tmp/unit_tests.o")
+t_stress=$(best "$reps" $cxx $flags -c bench/compile_stress.cpp -o "$tmp/stress.o")
+t_link=$(best "$reps" $cxx "$tmp/stress.o" -o "$tmp/stress")
+longest=$(nm "$tmp/stress.o" | awk '{ if (length($NF) > m) m = length($NF) } END { print m }')
+# Debug build of the stress TU: debug info repeats every type name
+t_stress_g=$(best "$reps" $cxx $flags -g -c bench/compile_stress.cpp -o "$tmp/stress_g.o")
+t_link_g=$(best "$reps" $cxx "$tmp/stress_g.o" -o "$tmp/stress_g")
+
+printf '%-36s %8s s\n' "compile tests/unit_tests.cpp" "$t_tests"
+printf '%-36s %8s s\n' "compile bench/compile_stress.cpp" "$t_stress"
+printf '%-36s %8s s\n' "link compile_stress" "$t_link"
+printf '%-36s %8s B\n' "compile_stress.o size" "$(wc -c < "$tmp/stress.o")"
+printf '%-36s %8s B\n' "compile_stress.o symbol table" "$(nm "$tmp/stress.o" | wc -c)"
+printf '%-36s %8s chars\n' "longest symbol" "$longest"
+printf '%-36s %8s s\n' "compile compile_stress.cpp -g" "$t_stress_g"
+printf '%-36s %8s s\n' "link compile_stress -g" "$t_link_g"
+printf '%-36s %8s B\n' "compile_stress.o size -g" "$(wc -c < "$tmp/stress_g.o")"
+printf '%-36s %8s B\n' "compile_stress size -g (linked)" "$(wc -c < "$tmp/stress_g")"
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+// Implementation detail of ecs.h: reading a snapshot file into memory. Kept
+// apart so that the POSIX headers it needs are confined to this one file.
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace detail {
+    // Whole file, privately mapped (copy-on-write) where mmap is available,
+    // otherwise read into one heap buffer. The returned pointer owns it.
+    inline std::shared_ptr<void> map_file(const std::string& path, size_t& size) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("map_file: cannot open " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0) { ::close(fd); throw std::runtime_error("map_file: cannot stat " + path); }
+        size = static_cast<size_t>(st.st_size);
+        if (size == 0) { ::close(fd); throw std::runtime_error("map_file: empty file " + path); }
+        void* base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) throw std::runtime_error("map_file: mmap failed for " + path);
+        return std::shared_ptr<void>(base, [size](void* p) { ::munmap(p, size); });
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("map_file: cannot open " + path);
+        size = static_cast<size_t>(in.tellg());
+        std::shared_ptr<std::byte[]> buf(new std::byte[size]);
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(buf.get()), size)) throw std::runtime_error("map_file: cannot read " + path);
+        return std::shared_ptr<void>(buf, buf.get());
+#endif
+    }
+}
@@ -2,146 +2,726 @@
 #include <cmath>
 #include <compare>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
 #include <ostream>
-#include <string>
-
-template <int M, int L, int T, int I=0, int K=0, int N=0, int J=0>
-struct Dimensions {
-    static constexpr int mass       = M;
-    static constexpr int length     = L;
-    static constexpr int time       = T;
-    static constexpr int current    = I;
-    static constexpr int temp       = K;
-    static constexpr int amount     = N;
-    static constexpr int luminosity = J;
+#include <string_view>
+#include <type_traits>
+
+namespace detail {
+    // Seven SI base dimensions, then eight extension slots (see BaseDim)
+    inline constexpr int kSiDims   = 7;
+    inline constexpr int kExtDims  = 8;
+    inline constexpr int kBaseDims = kSiDims + kExtDims;
+
+    // Exponent numerators over a common denominator, as plain constexpr data
+    // so that dimension arithmetic is a function call rather than a chain of
+    // class template instantiations
+    struct Exponents {
+        int e[kBaseDims];
+        int den;
+    };
+
+    // Positive denominator, numerators and denominator coprime
+    constexpr Exponents lowest_terms(Exponents x) {
+        if (x.den == 1) return x;
+        if (x.den == 0) throw "Dimensions: zero denominator";   // not a constant expression
+        if (x.den < 0) {
+            for (int& v : x.e) v = -v;
+            x.den = -x.den;
+        }
+        int g = x.den;
+        for (int v : x.e) g = std::gcd(g, v);
+        if (g > 1) {
+            for (int& v : x.e) v /= g;
+            x.den /= g;
+        }
+        return x;
+    }
+
+    // The exponent vector in two words, so that a dimension is two template
+    // arguments. The SI code holds the seven SI numerators as signed bytes
+    // 0..6 (mass first) and denominator − 1 in byte 7, so integer SI
+    // dimensions have a zero top byte; the extension code holds the eight
+    // extension numerators and is zero unless one is used.
+    using DimCode = std::uint64_t;
+
+    struct DimCodes {
+        DimCode si, ext;
+        friend constexpr bool operator==(DimCodes, DimCodes) = default;
+    };
+
+    constexpr DimCode encode_byte(int v, int i) {
+        if (v < -128 || v > 127) throw "Dimensions: exponent out of range";   // not a constant expression
+        return DimCode(std::uint8_t(v)) << (8 * i);
+    }
+
+    constexpr DimCodes encode(Exponents x) {
+        x = lowest_terms(x);
+        if (x.den > 256) throw "Dimensions: denominator exceeds 256";      // not a constant expression
+        DimCodes c{DimCode(x.den - 1) << 56, 0};
+        for (int i = 0; i < kSiDims; ++i)  c.si  |= encode_byte(x.e[i], i);
+        for (int i = 0; i < kExtDims; ++i) c.ext |= encode_byte(x.e[kSiDims + i], i);
+        return c;
+    }
+
+    constexpr int exponent(DimCode c, int i) { return std::int8_t(std::uint8_t(c >> (8 * i))); }
+    constexpr int denominator(DimCode c)     { return int(c >> 56) + 1; }
+
+    constexpr Exponents decode(DimCode si, DimCode ext) {
+        Exponents x{{}, denominator(si)};
+        for (int i = 0; i < kSiDims; ++i)  x.e[i] = exponent(si, i);
+        for (int i = 0; i < kExtDims; ++i) x.e[kSiDims + i] = exponent(ext, i);
+        return x;
+    }
+
+    // a + sign · b
+    constexpr Exponents combine(Exponents a, Exponents b, int sign) {
+        if (a.den == b.den) {
+            for (int i = 0; i < kBaseDims; ++i) a.e[i] += sign * b.e[i];
+            return lowest_terms(a);
+        }
+        const int l = std::lcm(a.den, b.den);
+        Exponents r{{}, l};
+        for (int i = 0; i < kBaseDims; ++i) r.e[i] = a.e[i] * (l / a.den) + sign * b.e[i] * (l / b.den);
+        return lowest_terms(r);
+    }
+
+    // Whether x (in lowest terms) fits the codes
+    constexpr bool encodable(const Exponents& x) {
+        if (x.den > 256) return false;
+        for (int v : x.e)
+            if (v < -128 || v > 127) return false;
+        return true;
+    }
+
+    // a ± b on one code word, byte by byte without carry into the neighbour
+    // (SWAR); H selects the sign bit of each exponent byte and L the rest.
+    // False if any byte overflows.
+    constexpr bool swar_combine(DimCode a, DimCode b, int sign, DimCode H, DimCode L, DimCode& r) {
+        r = sign > 0 ? ((a & L) + (b & L)) ^ ((a ^ b) & H)
+                     : ((a | H) - (b & L)) ^ ((a ^ ~b) & H);
+        return ((sign > 0 ? ~(a ^ b) : (a ^ b)) & (a ^ r) & H) == 0;
+    }
+
+    // a ± b through the exponent vectors; false if the result does not fit
+    constexpr bool combine_codes_general(DimCodes a, DimCodes b, int sign, DimCodes& out) {
+        const Exponents x = combine(decode(a.si, a.ext), decode(b.si, b.ext), sign);
+        if (!encodable(x)) return false;
+        out = encode(x);
+        return true;
+    }
+
+    // a ± b directly on the codes when both dimensions have integer
+    // exponents: a few word operations for the SI code and as many for the
+    // extension code. Everything else, including byte overflow, takes the
+    // general path, kept out of line so this one stays small enough to
+    // inline at run time. Returns false, leaving out alone, if the result
+    // does not fit the codes.
+    constexpr bool try_combine_codes(DimCodes a, DimCodes b, int sign, DimCodes& out) {
+        if (((a.si | b.si) >> 56) == 0) {
+            DimCode si = 0, ext = 0;
+            const bool si_ok  = swar_combine(a.si, b.si, sign, 0x0080808080808080, 0x007f7f7f7f7f7f7f, si);
+            const bool ext_ok = (a.ext | b.ext) == 0 ||
+                                swar_combine(a.ext, b.ext, sign, 0x8080808080808080, 0x7f7f7f7f7f7f7f7f, ext);
+            if (si_ok && ext_ok) {
+                out = {si, ext};
+                return true;
+            }
+        }
+        return combine_codes_general(a, b, sign, out);
+    }
+
+    constexpr DimCodes combine_codes(DimCodes a, DimCodes b, int sign) {
+        DimCodes r{};
+        if (!try_combine_codes(a, b, sign, r)) throw "Dimensions: exponent out of range";   // not a constant expression
+        return r;
+    }
+
+    // x · p/q
+    constexpr Exponents scale(Exponents x, int p, int q) {
+        for (int& v : x.e) v *= p;
+        x.den *= q;
+        return lowest_terms(x);
+    }
+}
+
+// A dimension as packed codes (see detail::encode). Spell dimensions with the
+// Dimensions and BaseDim aliases below; Dims is what appears in types and
+// symbols, so Quantity<Dimensions<1,2,-2>> mangles with two integers instead
+// of eight.
+template <detail::DimCode Code, detail::DimCode Ext = 0>
+struct Dims {
+    static constexpr detail::DimCode code = Code;
+    static constexpr detail::DimCode ext  = Ext;
+    static constexpr int mass       = detail::exponent(Code, 0);
+    static constexpr int length     = detail::exponent(Code, 1);
+    static constexpr int time       = detail::exponent(Code, 2);
+    static constexpr int current    = detail::exponent(Code, 3);
+    static constexpr int temp       = detail::exponent(Code, 4);
+    static constexpr int amount     = detail::exponent(Code, 5);
+    static constexpr int luminosity = detail::exponent(Code, 6);
+    static constexpr int den        = detail::denominator(Code);
+
+    // Numerator of extension base dimension `slot` (0..7)
+    static constexpr int base(int slot) { return detail::exponent(Ext, slot); }
 };
 
+namespace detail {
+    template <typename D>
+    constexpr Exponents decode() { return decode(D::code, D::ext); }
+
+    // Extension slot `slot` alone, with exponent p/q
+    constexpr Exponents base_exponents(int slot, int p, int q) {
+        if (slot < 0 || slot >= kExtDims) throw "BaseDim: slot out of range";   // not a constant expression
+        Exponents x{{}, q};
+        x.e[kSiDims + slot] = p;
+        return x;
+    }
+}
+
+// Exponents are rationals over one shared positive denominator: the mass
+// exponent is M/Den, and so on. Den is 1 for every SI-derived unit, so
+// Dimensions<1,2,-2> is still energy; sqrt(Velocity) has dimension
+// Dimensions<0,1,-1,0,0,0,0,2>, i.e. m^(1/2)·s^(-1/2). The alias reduces to
+// lowest terms, so each dimension has exactly one type. Numerators must fit
+// in [-128, 127] and the reduced denominator in [1, 256].
+template <int M, int L, int T, int I=0, int K=0, int N=0, int J=0, int Den=1>
+using Dimensions = Dims<detail::encode({{M, L, T, I, K, N, J}, Den}).si,
+                        detail::encode({{M, L, T, I, K, N, J}, Den}).ext>;
+
+// Extension base dimension `Slot` (0..7) raised to P/Q, for quantities the
+// seven SI dimensions cannot tell apart: angle, information, counts. Combine
+// with SI dimensions through DimAdd / DimSub, e.g. bit/s is
+// DimSub<BaseDim<1>, Dimensions<0,0,1>>::type. Specialise BaseDimension<Slot>
+// to name a slot in stream output; units.h names slots 0–2.
+template <int Slot, int P = 1, int Q = 1>
+using BaseDim = Dims<detail::encode(detail::base_exponents(Slot, P, Q)).si,
+                     detail::encode(detail::base_exponents(Slot, P, Q)).ext>;
+
+template <int Slot>
+struct BaseDimension;   // static constexpr const char* symbol
+
+// Symbol for a whole dimension in named output (named(q), the 'n' format
+// spec): specialise UnitSymbol<Energy::DimensionType> with symbol "J".
+// Dimensions without one fall back to base units. units.h names the SI
+// derived units that have an unambiguous dimension.
+template <typename D>
+struct UnitSymbol;      // static constexpr const char* symbol
+
 template <typename D1, typename D2>
 struct DimAdd {
-    using type = Dimensions<
-        D1::mass    + D2::mass,    D1::length + D2::length, D1::time   + D2::time,
-        D1::current + D2::current, D1::temp   + D2::temp,
-        D1::amount  + D2::amount,  D1::luminosity + D2::luminosity>;
+    static constexpr detail::DimCodes c = detail::combine_codes({D1::code, D1::ext}, {D2::code, D2::ext}, 1);
+    using type = Dims<c.si, c.ext>;
 };
 
 template <typename D1, typename D2>
 struct DimSub {
-    using type = Dimensions<
-        D1::mass    - D2::mass,    D1::length - D2::length, D1::time   - D2::time,
-        D1::current - D2::current, D1::temp   - D2::temp,
-        D1::amount  - D2::amount,  D1::luminosity - D2::luminosity>;
+    static constexpr detail::DimCodes c = detail::combine_codes({D1::code, D1::ext}, {D2::code, D2::ext}, -1);
+    using type = Dims<c.si, c.ext>;
+};
+
+// Multiply all exponents by the rational P/Q — used by pow<P, Q>
+template<typename D, int P, int Q = 1>
+struct DimPow {
+    static_assert(Q != 0, "pow: zero denominator");
+    static constexpr detail::DimCodes c = detail::encode(detail::scale(detail::decode<D>(), P, Q));
+    using type = Dims<c.si, c.ext>;
 };
 
 // Multiply all exponents by N — used by pow<N>
 template<typename D, int N>
 struct DimScale {
-    using type = Dimensions<D::mass*N, D::length*N, D::time*N,
-                            D::current*N, D::temp*N, D::amount*N, D::luminosity*N>;
+    using type = typename DimPow<D, N>::type;
 };
 
-// Halve all exponents — used by sqrt; requires all exponents to be even
+// Halve all exponents — used by sqrt; odd exponents become halves
 template<typename D>
 struct DimHalve {
-    static_assert(D::mass       % 2 == 0, "sqrt: mass exponent must be even");
-    static_assert(D::length     % 2 == 0, "sqrt: length exponent must be even");
-    static_assert(D::time       % 2 == 0, "sqrt: time exponent must be even");
-    static_assert(D::current    % 2 == 0, "sqrt: current exponent must be even");
-    static_assert(D::temp       % 2 == 0, "sqrt: temp exponent must be even");
-    static_assert(D::amount     % 2 == 0, "sqrt: amount exponent must be even");
-    static_assert(D::luminosity % 2 == 0, "sqrt: luminosity exponent must be even");
-    using type = Dimensions<D::mass/2, D::length/2, D::time/2,
-                            D::current/2, D::temp/2, D::amount/2, D::luminosity/2>;
+    using type = typename DimPow<D, 1, 2>::type;
 };
 
 // Forward declaration needed for IsQuantity concept
-template <typename Dim>
+template <typename Dim, typename Rep = double>
 struct Quantity;
 
 template <typename T>
 concept IsQuantity = requires {
     typename T::DimensionType;
-} && std::is_same_v<T, Quantity<typename T::DimensionType>>;
+    typename T::RepType;
+} && std::is_same_v<T, Quantity<typename T::DimensionType, typename T::RepType>>;
+
+// Same dimension, different storage type — e.g. RebindRep<Velocity, float>
+template <IsQuantity Q, typename Rep>
+using RebindRep = Quantity<typename Q::DimensionType, Rep>;
+
+namespace detail {
+    // Rep of Quantity<D, Rep> * S for an arithmetic scalar S: the common type
+    // when there is one, as for two quantities, and Rep otherwise
+    template <typename Rep, typename S>
+    struct scalar_rep { using type = Rep; };
+    template <typename Rep, typename S>
+        requires requires { typename std::common_type<Rep, S>::type; }
+    struct scalar_rep<Rep, S> { using type = std::common_type_t<Rep, S>; };
 
-template <typename Dim>
+    template <typename Rep, typename S>
+    using scalar_rep_t = typename scalar_rep<Rep, S>::type;
+}
+
+// Rep is the storage type of `value` (double unless stated). Binary operators
+// between quantities of different Reps compute in std::common_type_t of the
+// two, mirroring the built-in arithmetic conversions. Arithmetic scalars
+// follow the same rule, so an integer quantity times 0.5 is a double
+// quantity rather than zero; a scalar of type Rep itself keeps the Rep.
+template <typename Dim, typename Rep>
 struct Quantity {
     using DimensionType = Dim;
-    double value;
-    explicit constexpr Quantity(double v) : value(v) {}
+    using RepType       = Rep;
+    Rep value;
+    explicit constexpr Quantity(Rep v) : value(v) {}
+
+    // Explicit change of representation (see also quantity_cast)
+    template <typename R2>
+        requires (!std::is_same_v<R2, Rep>)
+    explicit constexpr Quantity(Quantity<Dim, R2> q) : value(static_cast<Rep>(q.value)) {}
 
     // Quantity * Quantity → DimAdd
     template <IsQuantity RHS>
     constexpr auto operator*(RHS rhs) const {
-        return Quantity<typename DimAdd<Dim, typename RHS::DimensionType>::type>(value * rhs.value);
+        using R = std::common_type_t<Rep, typename RHS::RepType>;
+        return Quantity<typename DimAdd<Dim, typename RHS::DimensionType>::type, R>(
+            static_cast<R>(value) * static_cast<R>(rhs.value));
     }
 
     // Quantity / Quantity → DimSub
     template <IsQuantity RHS>
     constexpr auto operator/(RHS rhs) const {
-        return Quantity<typename DimSub<Dim, typename RHS::DimensionType>::type>(value / rhs.value);
+        using R = std::common_type_t<Rep, typename RHS::RepType>;
+        return Quantity<typename DimSub<Dim, typename RHS::DimensionType>::type, R>(
+            static_cast<R>(value) / static_cast<R>(rhs.value));
     }
 
     // Same-dimension addition
-    constexpr Quantity operator+(Quantity rhs) const { return Quantity(value + rhs.value); }
+    template <typename R2>
+    constexpr auto operator+(Quantity<Dim, R2> rhs) const {
+        using R = std::common_type_t<Rep, R2>;
+        return Quantity<Dim, R>(static_cast<R>(value) + static_cast<R>(rhs.value));
+    }
 
     // Same-dimension subtraction
-    constexpr Quantity operator-(Quantity rhs) const { return Quantity(value - rhs.value); }
+    template <typename R2>
+    constexpr auto operator-(Quantity<Dim, R2> rhs) const {
+        using R = std::common_type_t<Rep, R2>;
+        return Quantity<Dim, R>(static_cast<R>(value) - static_cast<R>(rhs.value));
+    }
 
     // Unary negation
     constexpr Quantity operator-() const { return Quantity(-value); }
 
     // Scalar multiplication
-    constexpr Quantity operator*(double s) const { return Quantity(value * s); }
-    friend constexpr Quantity operator*(double s, Quantity q) { return Quantity(s * q.value); }
+    constexpr Quantity operator*(Rep s) const { return Quantity(value * s); }
+    friend constexpr Quantity operator*(Rep s, Quantity q) { return Quantity(s * q.value); }
+
+    template <typename S>
+        requires std::is_arithmetic_v<S> && (!std::is_same_v<S, Rep>)
+    constexpr auto operator*(S s) const {
+        using R = detail::scalar_rep_t<Rep, S>;
+        return Quantity<Dim, R>(static_cast<R>(value) * static_cast<R>(s));
+    }
+    template <typename S>
+        requires std::is_arithmetic_v<S> && (!std::is_same_v<S, Rep>)
+    friend constexpr auto operator*(S s, Quantity q) {
+        using R = detail::scalar_rep_t<Rep, S>;
+        return Quantity<Dim, R>(static_cast<R>(s) * static_cast<R>(q.value));
+    }
 
     // Scalar division
-    constexpr Quantity operator/(double s) const { return Quantity(value / s); }
+    constexpr Quantity operator/(Rep s) const { return Quantity(value / s); }
+
+    template <typename S>
+        requires std::is_arithmetic_v<S> && (!std::is_same_v<S, Rep>)
+    constexpr auto operator/(S s) const {
+        using R = detail::scalar_rep_t<Rep, S>;
+        return Quantity<Dim, R>(static_cast<R>(value) / static_cast<R>(s));
+    }
 
     // Spaceship comparison (requires same dimension — enforced by type system)
     constexpr auto operator<=>(const Quantity&) const = default;
 };
 
+// quantity_cast<R>(q) — same dimension, value converted to representation R
+template <typename R, IsQuantity Q>
+constexpr auto quantity_cast(Q q) {
+    return Quantity<typename Q::DimensionType, R>(static_cast<R>(q.value));
+}
+
+namespace detail {
+    // Q is its Rep and nothing else: same size and alignment, standard layout
+    // and trivially copyable, so an array of one can be viewed as an array of
+    // the other (as_quantities / as_doubles in quantity_vector.h)
+    template <typename Q>
+    inline constexpr bool rep_layout_v =
+        sizeof(Q) == sizeof(typename Q::RepType) && alignof(Q) == alignof(typename Q::RepType) &&
+        std::is_standard_layout_v<Q> && std::is_trivially_copyable_v<Q>;
+}
+
+static_assert(detail::rep_layout_v<Quantity<Dimensions<0, 0, 0>, double>>);
+static_assert(detail::rep_layout_v<Quantity<Dimensions<1, 1, -2>, float>>);
+
 // =============================================================================
 // Math free functions
 // =============================================================================
 
-// pow<N>(q) — raise a Quantity to an integer power; scales all dimension exponents by N
-template<int N, IsQuantity Q>
+namespace detail {
+    // Multiplications in the square-and-multiply chain for x^n (n >= 1)
+    constexpr int binary_chain_cost(unsigned n) {
+        int c = 0;
+        for (; n > 1; n >>= 1) c += 1 + (n & 1);
+        return c;
+    }
+
+    // Cheapest of square-and-multiply and the factor method (x^(pq) as
+    // (x^p)^q), applied recursively — e.g. x^15 in 5 multiplications, not 6
+    constexpr int chain_cost(unsigned n) {
+        int best = binary_chain_cost(n);
+        for (unsigned p = 3; p * p <= n; p += 2)
+            if (n % p == 0 && chain_cost(p) + chain_cost(n / p) < best) best = chain_cost(p) + chain_cost(n / p);
+        return best;
+    }
+
+    // The odd factor that makes the factor method cheaper for n, or 0
+    constexpr unsigned chain_factor(unsigned n) {
+        for (unsigned p = 3; p * p <= n; p += 2)
+            if (n % p == 0 && chain_cost(p) + chain_cost(n / p) < binary_chain_cost(n)) return p;
+        return 0;
+    }
+
+    // x^N as a multiplication chain chosen at compile time
+    template <unsigned N, typename R>
+    constexpr R pow_chain(R x) {
+        if constexpr (N == 1) {
+            return x;
+        } else if constexpr (constexpr unsigned p = chain_factor(N); p != 0) {
+            return pow_chain<N / p>(pow_chain<p>(x));
+        } else if constexpr (N % 2 == 0) {
+            const R h = pow_chain<N / 2>(x);
+            return static_cast<R>(h * h);
+        } else {
+            return static_cast<R>(pow_chain<N - 1>(x) * x);
+        }
+    }
+}
+
+namespace detail {
+    // Real-exponent functions of a user-defined Rep, by argument-dependent lookup
+    template <typename R>
+    inline constexpr bool has_real_root_v = requires(R x) { cbrt(x); };
+    template <typename R>
+    inline constexpr bool has_real_pow_v = requires(R x) { pow(x, 1.0); };
+
+    // x^N for any integer N: a multiplication chain, plus one reciprocal for N < 0
+    template <int N, typename R>
+    constexpr R int_pow(R x) {
+        if constexpr (N == 0)     return R(1);
+        else if constexpr (N > 0) return pow_chain<unsigned(N)>(x);
+        else                      return static_cast<R>(R(1) / pow_chain<unsigned(-N)>(x));
+    }
+}
+
+// pow<N>(q) — raise a Quantity to an integer power; scales all dimension exponents by N.
+// Expands to a multiplication chain (and one reciprocal for N < 0), so it is
+// usable in constant expressions and costs a handful of multiplies at run time.
+//
+// pow<P, Q>(q) raises to the rational power P/Q. Square and cube roots (Q of
+// 2 or 3 in lowest terms) are a sqrt or cbrt followed by the integer chain;
+// other denominators call std::pow. An integer Rep is evaluated in double and
+// converted back, as sqrt does. A user-defined Rep supplies cbrt(Rep) and
+// pow(Rep, double) for argument-dependent lookup; FixedPoint and simd::Pack do.
+template<int N, int D = 1, IsQuantity Q>
 constexpr auto pow(Q q) {
-    return Quantity<typename DimScale<typename Q::DimensionType, N>::type>(std::pow(q.value, N));
+    static_assert(D != 0, "pow: zero denominator");
+    constexpr int g = std::gcd(N, D) * (D < 0 ? -1 : 1);
+    constexpr int n = N / g, d = D / g;
+    using R = typename Q::RepType;
+    using Result = Quantity<typename DimPow<typename Q::DimensionType, n, d>::type, R>;
+    if constexpr (d == 1) {
+        return Result(detail::int_pow<n>(q.value));
+    } else if constexpr (d == 2) {
+        using std::sqrt;
+        return Result(detail::int_pow<n>(static_cast<R>(sqrt(q.value))));
+    } else if constexpr (std::is_arithmetic_v<R>) {
+        using F = std::conditional_t<std::is_floating_point_v<R>, R, double>;
+        const F x = static_cast<F>(q.value);
+        if constexpr (d == 3) return Result(detail::int_pow<n>(static_cast<R>(std::cbrt(x))));
+        else                  return Result(static_cast<R>(std::pow(x, F(n) / F(d))));
+    } else if constexpr (d == 3) {
+        static_assert(detail::has_real_root_v<R>, "pow<P, 3>: Rep needs cbrt(Rep) found by ADL");
+        return Result(detail::int_pow<n>(static_cast<R>(cbrt(q.value))));
+    } else {
+        static_assert(detail::has_real_pow_v<R>, "pow<P, Q>: Rep needs pow(Rep, double) found by ADL");
+        return Result(static_cast<R>(pow(q.value, double(n) / double(d))));
+    }
 }
 
-// sqrt(q) — square root; requires all dimension exponents to be even (checked at compile time)
+// sqrt(q) — square root; halves every dimension exponent
 template<IsQuantity Q>
 constexpr auto sqrt(Q q) {
-    return Quantity<typename DimHalve<typename Q::DimensionType>::type>(std::sqrt(q.value));
+    using R = typename Q::RepType;
+    using std::sqrt;
+    return Quantity<typename DimHalve<typename Q::DimensionType>::type, R>(static_cast<R>(sqrt(q.value)));
+}
+
+// cbrt(q) — cube root; divides every dimension exponent by 3
+template<IsQuantity Q>
+constexpr auto cbrt(Q q) {
+    return pow<1, 3>(q);
 }
 
 // abs(q) — absolute value; preserves dimension
 template<IsQuantity Q>
-constexpr Q abs(Q q) { return Q(std::abs(q.value)); }
+constexpr Q abs(Q q) {
+    using std::abs;
+    return Q(abs(q.value));
+}
+
+namespace detail {
+    // FP_FAST_FMA[F] is defined when std::fma is a single hardware instruction
+#if defined(FP_FAST_FMA)
+    inline constexpr bool kFastFma = true;
+#else
+    inline constexpr bool kFastFma = false;
+#endif
+#if defined(FP_FAST_FMAF)
+    inline constexpr bool kFastFmaF = true;
+#else
+    inline constexpr bool kFastFmaF = false;
+#endif
+
+    // a * b + c, as one fused instruction where the target has one. Without
+    // hardware FMA, std::fma is a slow software routine, so the plain
+    // expression is used instead (rounded twice, unless the compiler
+    // contracts it).
+    template <typename R>
+    constexpr R fma_value(R a, R b, R c) {
+        if constexpr ((std::is_same_v<R, double> && kFastFma) || (std::is_same_v<R, float> && kFastFmaF)) {
+            if (!std::is_constant_evaluated()) return std::fma(a, b, c);
+        }
+        return static_cast<R>(a * b + c);
+    }
+
+    // Smallest magnitude whose square is still accurate (2^((min_exp - 1 + digits - 1) / 2))
+    template <typename R>
+    constexpr R hypot_floor() {
+        R r = 1;
+        for (int e = (std::numeric_limits<R>::min_exponent - 1 + std::numeric_limits<R>::digits - 1) / 2; e < 0; ++e)
+            r /= 2;
+        return r;
+    }
+}
+
+// fma(a, b, c) — a * b + c in one rounding where the hardware supports it.
+// The dimension of a * b must equal that of c.
+template<IsQuantity A, IsQuantity B, IsQuantity C>
+    requires std::is_same_v<typename DimAdd<typename A::DimensionType, typename B::DimensionType>::type,
+                            typename C::DimensionType>
+constexpr auto fma(A a, B b, C c) {
+    using R = std::common_type_t<typename A::RepType, typename B::RepType, typename C::RepType>;
+    return Quantity<typename C::DimensionType, R>(
+        detail::fma_value(static_cast<R>(a.value), static_cast<R>(b.value), static_cast<R>(c.value)));
+}
+
+// hypot(a, b) — sqrt(a² + b²) for same-dimension quantities. Computed as
+// sqrt(fma(a, a, b²)); results so large or small that the squares would
+// overflow or lose precision are recomputed with std::hypot.
+template<IsQuantity Q>
+auto hypot(Q a, Q b) {
+    using R = typename Q::RepType;
+    using std::sqrt;
+    if constexpr (std::is_floating_point_v<R>) {
+        const R r = sqrt(detail::fma_value(a.value, a.value, b.value * b.value));
+        if (!(r >= detail::hypot_floor<R>() && r <= std::numeric_limits<R>::max()))
+            return Q(std::hypot(a.value, b.value));
+        return Q(r);
+    } else {
+        return Q(static_cast<R>(sqrt(a.value * a.value + b.value * b.value)));
+    }
+}
+
+// lerp(a, b, t) — a + t (b − a) for same-dimension quantities and a
+// dimensionless t, as one fused multiply-add; exact at t = 0 and t = 1.
+// Endpoints of opposite sign, where b − a can overflow, take std::lerp's
+// t b + (1 − t) a instead.
+template<IsQuantity Q, typename T>
+    requires std::is_arithmetic_v<T>
+constexpr Q lerp(Q a, Q b, T t) {
+    using R = typename Q::RepType;
+    if (t == T(0)) return a;
+    if (t == T(1)) return b;
+    if constexpr (std::is_floating_point_v<R>) {
+        if ((a.value <= R(0) && b.value >= R(0)) || (a.value >= R(0) && b.value <= R(0)))
+            return Q(static_cast<R>(t) * b.value + (R(1) - static_cast<R>(t)) * a.value);
+    }
+    return Q(detail::fma_value(static_cast<R>(t), static_cast<R>(b.value - a.value), a.value));
+}
+
+// midpoint(a, b) — (a + b) / 2 without intermediate overflow (std::midpoint)
+template<IsQuantity Q>
+constexpr Q midpoint(Q a, Q b) {
+    using R = typename Q::RepType;
+    if constexpr (std::is_arithmetic_v<R>) return Q(std::midpoint(a.value, b.value));
+    else                                   return Q((a.value + b.value) / R(2));
+}
 
 // =============================================================================
 // Stream output  (e.g.  "9.81 [m·s^-2]")
 // =============================================================================
 
 namespace detail {
+    // Symbol of extension slot S, or null if BaseDimension<S> is not specialised.
+    // Callers pass their dimension as D so the lookup is deferred to the point
+    // of use, after units.h and user code have specialised BaseDimension.
+    template <int S, typename D>
+    constexpr const char* base_symbol() {
+        if constexpr (requires { BaseDimension<S>::symbol; }) return BaseDimension<S>::symbol;
+        else                                                  return nullptr;
+    }
+
+    // Counts characters, or also stores them when given a buffer
+    struct TextSink {
+        char*       out  = nullptr;
+        std::size_t size = 0;
+        constexpr void put(char c) {
+            if (out) out[size] = c;
+            ++size;
+        }
+        constexpr void put(const char* s) { while (*s) put(*s++); }
+        constexpr void put_int(int v) {
+            if (v < 0) put('-');
+            char digits[12];
+            int  n = 0;
+            do { digits[n++] = char('0' + (v < 0 ? -(v % 10) : v % 10)); v /= 10; } while (v != 0);
+            while (n) put(digits[--n]);
+        }
+    };
+
+    // Names of the base dimensions, null for an unnamed extension slot
     template<typename D>
-    inline std::string dim_string() {
-        const char* names[7] = {"kg", "m", "s", "A", "K", "mol", "cd"};
-        const int   exps[7]  = {D::mass, D::length, D::time, D::current,
-                                 D::temp, D::amount, D::luminosity};
-        std::string result;
-        for (int i = 0; i < 7; ++i) {
-            if (exps[i] == 0) continue;
-            if (!result.empty()) result += "\xc2\xb7"; // UTF-8 middle dot ·
-            result += names[i];
-            if (exps[i] != 1) { result += '^'; result += std::to_string(exps[i]); }
+    inline constexpr const char* base_names[kBaseDims] = {
+        "kg", "m", "s", "A", "K", "mol", "cd",
+        base_symbol<0, D>(), base_symbol<1, D>(), base_symbol<2, D>(), base_symbol<3, D>(),
+        base_symbol<4, D>(), base_symbol<5, D>(), base_symbol<6, D>(), base_symbol<7, D>()};
+
+    // "kg·m^2·s^-2", "m^(1/2)", or "1" when every exponent is zero
+    constexpr void write_exponents(TextSink& s, const Exponents& x, const char* const* names) {
+        const std::size_t start = s.size;
+        for (int i = 0; i < kBaseDims; ++i) {
+            if (x.e[i] == 0) continue;
+            if (s.size != start) s.put("\xc2\xb7"); // UTF-8 middle dot ·
+            if (names[i]) s.put(names[i]);
+            else {
+                s.put("base");
+                s.put_int(i - kSiDims);
+            }
+            const int g = std::gcd(x.e[i], x.den), num = x.e[i] / g, den = x.den / g;
+            if (num == 1 && den == 1) continue;
+            s.put('^');
+            if (den == 1) s.put_int(num);
+            else {
+                s.put('(');
+                s.put_int(num);
+                s.put('/');
+                s.put_int(den);
+                s.put(')');
+            }
         }
-        return result.empty() ? "1" : result;
+        if (s.size == start) s.put('1');
+    }
+
+    template<typename D>
+    constexpr void write_dim_string(TextSink& s) { write_exponents(s, decode<D>(), base_names<D>); }
+
+    // N characters plus a terminating NUL, built at compile time
+    template<std::size_t N>
+    struct FixedString {
+        char chars[N + 1] = {};
+        constexpr std::string_view view() const { return {chars, N}; }
+    };
+
+    // UnitSymbol<D>::symbol if there is one, else the base-unit string
+    template<typename D>
+    constexpr void write_unit_symbol(TextSink& s) {
+        if constexpr (requires { UnitSymbol<D>::symbol; }) s.put(UnitSymbol<D>::symbol);
+        else                                               write_dim_string<D>(s);
+    }
+
+    template<typename D, bool Named>
+    constexpr void write_unit_suffix(TextSink& s) {
+        s.put(" [");
+        if constexpr (Named) write_unit_symbol<D>(s);
+        else                 write_dim_string<D>(s);
+        s.put(']');
+    }
+
+    // " [<dimension>]" — the suffix operator<< writes after the value
+    template<typename D, bool Named>
+    constexpr auto make_unit_suffix() {
+        constexpr std::size_t n = [] {
+            TextSink count;
+            write_unit_suffix<D, Named>(count);
+            return count.size;
+        }();
+        FixedString<n> text;
+        TextSink sink{text.chars};
+        write_unit_suffix<D, Named>(sink);
+        return text;
+    }
+
+    // One array per dimension, in static storage
+    template<typename D>
+    inline constexpr auto unit_suffix = make_unit_suffix<D, false>();
+    template<typename D>
+    inline constexpr auto named_unit_suffix = make_unit_suffix<D, true>();
+
+    template<typename D>
+    constexpr std::string_view dim_string() {
+        constexpr std::string_view suffix = unit_suffix<D>.view();
+        return suffix.substr(2, suffix.size() - 3);
     }
 }
 
+// Dimension of D as text, e.g. dim_string_v<Energy::DimensionType> is
+// "kg·m^2·s^-2". Computed at compile time; usable in static_assert conditions.
+template<typename D>
+inline constexpr std::string_view dim_string_v = detail::dim_string<D>();
+
+// Named symbol of D ("J"), or dim_string_v<D> when it has none
+template<typename D>
+inline constexpr std::string_view unit_symbol_v = [] {
+    constexpr std::string_view suffix = detail::named_unit_suffix<D>.view();
+    return suffix.substr(2, suffix.size() - 3);
+}();
+
 template<IsQuantity Q>
 std::ostream& operator<<(std::ostream& os, Q q) {
-    return os << q.value << " [" << detail::dim_string<typename Q::DimensionType>() << "]";
+    constexpr std::string_view suffix = detail::unit_suffix<typename Q::DimensionType>.view();
+    os << q.value;
+    return os.write(suffix.data(), std::streamsize(suffix.size()));
+}
+
+// os << named(q) prints "5 [J]" rather than "5 [kg·m^2·s^-2]"
+template<IsQuantity Q>
+struct NamedQuantity {
+    Q quantity;
+};
+
+template<IsQuantity Q>
+constexpr NamedQuantity<Q> named(Q q) { return {q}; }
+
+template<IsQuantity Q>
+std::ostream& operator<<(std::ostream& os, NamedQuantity<Q> n) {
+    constexpr std::string_view suffix = detail::named_unit_suffix<typename Q::DimensionType>.view();
+    os << n.quantity.value;
+    return os.write(suffix.data(), std::streamsize(suffix.size()));
 }
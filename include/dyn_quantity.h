@@ -0,0 +1,152 @@
+#pragma once
+#include "dimensions.h"
+#include <compare>
+#include <concepts>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+// A quantity whose dimension is known only at run time — a column read from
+// a file whose header names the unit, or a parsed string.
+//
+// DynQuantity is a double plus the codes a Dims<si, ext> type carries: the
+// seven SI exponents and the denominator packed into one 64-bit word, and the
+// extension slots in a second word that stays zero unless angle, information
+// or a user slot is involved. Multiplying or dividing adds or subtracts the
+// exponent bytes in place (detail::try_combine_codes), a few integer
+// instructions beside the floating-point one; a dimension check compares the
+// codes. as<Q>() is that check and a copy, and DynQuantity(q) from a typed
+// quantity is just the copy.
+//
+// Mismatches surface at run time instead of compile time: sums, differences
+// and ordering of different dimensions, and as<Q>() of the wrong type, throw
+// std::invalid_argument; a product whose exponents leave [-128, 127] throws
+// std::out_of_range. Typed quantities keep their compile-time checks — the
+// operators below need at least one DynQuantity operand.
+
+struct DynQuantity;
+
+namespace detail {
+    template <typename D>
+    inline constexpr DimCodes dim_codes_v{D::code, D::ext};
+
+    // Run-time counterpart of dim_string_v; extension slots are named by the
+    // BaseDimension specialisations visible where this header is included
+    inline std::string dim_string(DimCodes d) {
+        const Exponents x = decode(d.si, d.ext);
+        TextSink count;
+        write_exponents(count, x, base_names<DimCodes>);
+        std::string text(count.size, '\0');
+        TextSink fill{text.data()};
+        write_exponents(fill, x, base_names<DimCodes>);
+        return text;
+    }
+
+    [[noreturn]] inline void throw_dimension_mismatch(const char* what, DimCodes a, DimCodes b) {
+        throw std::invalid_argument(std::string("DynQuantity: ") + what + " [" + dim_string(a) + "] and [" + dim_string(b) + "]");
+    }
+
+    [[noreturn]] inline void throw_exponent_overflow() {
+        throw std::out_of_range("DynQuantity: exponent out of range");
+    }
+
+    constexpr DimCodes dyn_combine(DimCodes a, DimCodes b, int sign) {
+        DimCodes r{};
+        if (!try_combine_codes(a, b, sign, r)) throw_exponent_overflow();
+        return r;
+    }
+}
+
+struct DynQuantity {
+    double           value = 0.0;      // in SI units
+    detail::DimCodes dims{0, 0};       // as in Dims<si, ext>; {0, 0} is dimensionless
+
+    DynQuantity() = default;
+    constexpr DynQuantity(double v, detail::DimCodes d) : value(v), dims(d) {}
+
+    // Any typed quantity — always valid, so implicit
+    template <IsQuantity Q>
+        requires requires(typename Q::RepType r) { static_cast<double>(r); }
+    constexpr DynQuantity(Q q)
+        : value(static_cast<double>(q.value)), dims(detail::dim_codes_v<typename Q::DimensionType>) {}
+
+    template <IsQuantity Q>
+    constexpr bool is() const { return dims == detail::dim_codes_v<typename Q::DimensionType>; }
+
+    // Q, if the dimension is Q's; std::invalid_argument otherwise
+    template <IsQuantity Q>
+    constexpr Q as() const {
+        if (!is<Q>()) detail::throw_dimension_mismatch("as() between", dims, detail::dim_codes_v<typename Q::DimensionType>);
+        return Q(static_cast<typename Q::RepType>(value));
+    }
+
+    constexpr DynQuantity operator-() const { return {-value, dims}; }
+
+    constexpr DynQuantity operator*(double s) const { return {value * s, dims}; }
+    constexpr DynQuantity operator/(double s) const { return {value / s, dims}; }
+    friend constexpr DynQuantity operator*(double s, DynQuantity q) { return {s * q.value, q.dims}; }
+    friend constexpr DynQuantity operator/(double s, DynQuantity q) {
+        return {s / q.value, detail::dyn_combine({0, 0}, q.dims, -1)};
+    }
+};
+
+// A DynQuantity, or a typed quantity that converts to one; the operators take
+// any pair with at least one DynQuantity, so Length + Time stays a compile error
+template <typename T>
+concept DynOperand = std::same_as<T, DynQuantity> || IsQuantity<T>;
+
+template <typename A, typename B>
+concept DynOperands = DynOperand<A> && DynOperand<B> &&
+                      (std::same_as<A, DynQuantity> || std::same_as<B, DynQuantity>);
+
+template <typename A, typename B>
+    requires DynOperands<A, B>
+constexpr DynQuantity operator*(A a, B b) {
+    const DynQuantity x(a), y(b);
+    return {x.value * y.value, detail::dyn_combine(x.dims, y.dims, 1)};
+}
+
+template <typename A, typename B>
+    requires DynOperands<A, B>
+constexpr DynQuantity operator/(A a, B b) {
+    const DynQuantity x(a), y(b);
+    return {x.value / y.value, detail::dyn_combine(x.dims, y.dims, -1)};
+}
+
+template <typename A, typename B>
+    requires DynOperands<A, B>
+constexpr DynQuantity operator+(A a, B b) {
+    const DynQuantity x(a), y(b);
+    if (x.dims != y.dims) detail::throw_dimension_mismatch("cannot add", x.dims, y.dims);
+    return {x.value + y.value, x.dims};
+}
+
+template <typename A, typename B>
+    requires DynOperands<A, B>
+constexpr DynQuantity operator-(A a, B b) {
+    const DynQuantity x(a), y(b);
+    if (x.dims != y.dims) detail::throw_dimension_mismatch("cannot subtract", x.dims, y.dims);
+    return {x.value - y.value, x.dims};
+}
+
+// Equal means the same dimension and the same value; quantities of different
+// dimensions are unequal, but ordering them throws
+template <typename A, typename B>
+    requires DynOperands<A, B>
+constexpr bool operator==(A a, B b) {
+    const DynQuantity x(a), y(b);
+    return x.dims == y.dims && x.value == y.value;
+}
+
+template <typename A, typename B>
+    requires DynOperands<A, B>
+constexpr std::partial_ordering operator<=>(A a, B b) {
+    const DynQuantity x(a), y(b);
+    if (x.dims != y.dims) detail::throw_dimension_mismatch("cannot compare", x.dims, y.dims);
+    return x.value <=> y.value;
+}
+
+// "9.81 [m·s^-2]", as for a typed quantity of the same dimension
+inline std::ostream& operator<<(std::ostream& os, const DynQuantity& q) {
+    return os << q.value << " [" << detail::dim_string(q.dims) << ']';
+}
@@ -2,8 +2,18 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <new>
 #include <algorithm>
 #include <tuple>
+#include <type_traits>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <typeinfo>
+#include "detail/map_file.h"
 
 class TypeRegistry {
     static inline int counter = 0;
@@ -13,6 +23,132 @@ public:
         static const int id = counter++;
         return id;
     }
+
+    // Unlike get_id, stable across runs of the same binary — used to match
+    // snapshot sections to pools. FNV-1a over the implementation's type name.
+    template <typename T>
+    static std::uint64_t get_key() {
+        static const std::uint64_t key = [] {
+            std::uint64_t h = 14695981039346656037ull;
+            for (const char* c = typeid(T).name(); *c; ++c) h = (h ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+            return h;
+        }();
+        return key;
+    }
+};
+
+// Growable array backing ComponentPool. Behaves like a minimal std::vector but
+// can also adopt an externally owned buffer (a mapped snapshot) without copying;
+// the first operation that grows it copies the elements into owned storage.
+// It compares equal to, and converts to, a std::vector of the same elements, so
+// code written against the std::vector accessors keeps working.
+template <typename T>
+class PoolArray {
+    static_assert(!std::is_same_v<T, bool>, "PoolArray<bool> is unsupported — wrap the flag in a struct");
+    std::vector<T> owned;
+    T* ptr = nullptr;
+    size_t count = 0;
+    std::shared_ptr<const void> backing;   // keeps adopted memory alive; null while owned
+
+    void sync() { ptr = owned.data(); count = owned.size(); }
+    void own() {
+        if (!backing) return;
+        owned.assign(ptr, ptr + count);
+        backing.reset();
+        sync();
+    }
+public:
+    using value_type      = T;
+    using size_type       = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference       = T&;
+    using const_reference = const T&;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+    PoolArray() = default;
+    PoolArray(std::vector<T> v) : owned(std::move(v)) { sync(); }
+    PoolArray(const PoolArray& o) : owned(o.begin(), o.end()) { sync(); }
+    PoolArray(PoolArray&& o) noexcept
+        : owned(std::move(o.owned)), ptr(o.ptr), count(o.count), backing(std::move(o.backing)) {
+        o.ptr = nullptr;
+        o.count = 0;
+    }
+    PoolArray& operator=(PoolArray o) noexcept {
+        owned   = std::move(o.owned);
+        ptr     = o.ptr;
+        count   = o.count;
+        backing = std::move(o.backing);
+        o.ptr   = nullptr;
+        o.count = 0;
+        return *this;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    T& operator[](size_t i) { return ptr[i]; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+    T* begin() { return ptr; }
+    T* end() { return ptr + count; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+    T& front() { return ptr[0]; }
+    const T& front() const { return ptr[0]; }
+    T& back() { return ptr[count - 1]; }
+    const T& back() const { return ptr[count - 1]; }
+    const T* cbegin() const { return ptr; }
+    const T* cend() const { return ptr + count; }
+    const T& at(size_t i) const {
+        if (i >= count) throw std::out_of_range("PoolArray::at: index out of range");
+        return ptr[i];
+    }
+
+    operator std::vector<T>() const { return std::vector<T>(begin(), end()); }
+    friend bool operator==(const PoolArray& a, const PoolArray& b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+    friend bool operator==(const PoolArray& a, const std::vector<T>& b) { return std::equal(a.begin(), a.end(), b.begin(), b.end()); }
+
+    // Replace the contents with `n` elements copied bytewise from `src`.
+    void assign_bytes(const void* src, size_t n) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::vector<T> copy;
+        if constexpr (std::is_default_constructible_v<T>) {
+            copy.resize(n);
+            if (n) std::memcpy(static_cast<void*>(copy.data()), src, n * sizeof(T));
+        } else {
+            copy.reserve(n);
+            const auto* bytes = static_cast<const std::byte*>(src);
+            for (size_t i = 0; i < n; ++i) {
+                alignas(T) std::byte buf[sizeof(T)];
+                std::memcpy(buf, bytes + i * sizeof(T), sizeof(T));
+                copy.push_back(*std::launder(reinterpret_cast<T*>(buf)));
+            }
+        }
+        owned = std::move(copy);
+        backing.reset();
+        sync();
+    }
+
+    void push_back(T v) { own(); owned.push_back(std::move(v)); sync(); }
+    void resize(size_t n, const T& v) { own(); owned.resize(n, v); sync(); }
+    void reserve(size_t n) { own(); owned.reserve(n); sync(); }
+    void clear() { owned.clear(); backing.reset(); sync(); }
+    void truncate(size_t n) {
+        if (n >= count) return;
+        own();
+        owned.erase(owned.begin() + n, owned.end());
+        sync();
+    }
+
+    // View `n` elements at `p` in place; `keep` owns the memory.
+    void adopt(T* p, size_t n, std::shared_ptr<const void> keep) {
+        owned = std::vector<T>();
+        ptr = p;
+        count = n;
+        backing = std::move(keep);
+    }
+    bool adopted() const { return backing != nullptr; }
 };
 
 class BasePool {
@@ -20,13 +156,48 @@ public:
     virtual ~BasePool() = default;
     virtual bool contains(int entity) const = 0;
     virtual size_t size() const = 0;
+    virtual void clear() = 0;
+
+    // Raw storage access, used by Registry::snapshot / restore
+    virtual std::uint64_t type_key() const = 0;
+    virtual bool trivially_copyable() const = 0;
+    virtual size_t component_size() const = 0;
+    virtual size_t component_align() const = 0;
+    virtual const PoolArray<int>& sparse_array() const = 0;
+    virtual const PoolArray<int>& entity_array() const = 0;
+    virtual const void* dense_data() const = 0;
+    virtual void adopt(int* sparse, size_t sparse_count, int* entities, size_t entity_count,
+                       void* dense, size_t dense_count, std::shared_ptr<const void> backing) = 0;
+    virtual void assign_raw(const int* sparse, size_t sparse_count, const int* entities, size_t entity_count,
+                            const void* dense, size_t dense_count) = 0;
+};
+
+// Marker for Registry::view — Resource<T> in the component list passes the
+// registry's single T (see Registry::resource) instead of a per-entity component.
+template <typename T>
+struct Resource {};
+
+template <typename T> inline constexpr bool is_resource_v              = false;
+template <typename T> inline constexpr bool is_resource_v<Resource<T>> = true;
+
+class BaseResource {
+public:
+    virtual ~BaseResource() = default;
+};
+
+template <typename T>
+class ResourceSlot : public BaseResource {
+public:
+    T value;
+    template <typename... Args>
+    explicit ResourceSlot(Args&&... args) : value(std::forward<Args>(args)...) {}
 };
 
 template <typename T>
 class ComponentPool : public BasePool {
-    std::vector<int> sparse;
-    std::vector<int> entity_map;
-    std::vector<T> dense;
+    PoolArray<int> sparse;
+    PoolArray<int> entity_map;
+    PoolArray<T> dense;
 public:
     void assign(int entity, T comp) {
         if (entity >= (int)sparse.size()) sparse.resize(entity + 1, -1);
@@ -39,11 +210,154 @@ public:
         return entity < (int)sparse.size() && sparse[entity] != -1; 
     }
     size_t size() const override { return dense.size(); }
-    const std::vector<int>& entities() const { return entity_map; }
+    const PoolArray<int>& entities() const { return entity_map; }
+    PoolArray<T>& components() { return dense; }
+    const PoolArray<T>& components() const { return dense; }
+    void clear() override { sparse.clear(); entity_map.clear(); dense.clear(); }
+
+    // Slot-level writes, used to mirror another pool's layout exactly (see
+    // replication.h). place() puts `comp` for `entity` at dense index `idx`;
+    // idx == size() appends. truncate() drops every slot from `n` on.
+    void place(size_t idx, int entity, T comp) {
+        if (idx == dense.size()) { assign(entity, std::move(comp)); return; }
+        const int old = entity_map[idx];
+        if (sparse[old] == static_cast<int>(idx)) sparse[old] = -1;
+        if (entity >= (int)sparse.size()) sparse.resize(entity + 1, -1);
+        sparse[entity]  = static_cast<int>(idx);
+        entity_map[idx] = entity;
+        dense[idx]      = std::move(comp);
+    }
+    void truncate(size_t n) {
+        for (size_t idx = n; idx < dense.size(); ++idx)
+            if (sparse[entity_map[idx]] == static_cast<int>(idx)) sparse[entity_map[idx]] = -1;
+        entity_map.truncate(n);
+        dense.truncate(n);
+    }
+
+    std::uint64_t type_key() const override { return TypeRegistry::get_key<T>(); }
+    bool trivially_copyable() const override { return std::is_trivially_copyable_v<T>; }
+    size_t component_size() const override { return sizeof(T); }
+    size_t component_align() const override { return alignof(T); }
+    const PoolArray<int>& sparse_array() const override { return sparse; }
+    const PoolArray<int>& entity_array() const override { return entity_map; }
+    const void* dense_data() const override { return dense.data(); }
+
+    void adopt(int* sparse_in, size_t sparse_count, int* entities, size_t entity_count,
+               void* dense_in, size_t dense_count, std::shared_ptr<const void> backing) override {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            sparse.adopt(sparse_in, sparse_count, backing);
+            entity_map.adopt(entities, entity_count, backing);
+            if (reinterpret_cast<std::uintptr_t>(dense_in) % alignof(T) == 0)
+                dense.adopt(static_cast<T*>(dense_in), dense_count, std::move(backing));
+            else
+                dense.assign_bytes(dense_in, dense_count);
+        } else {
+            throw std::logic_error("ComponentPool::adopt: component is not trivially copyable");
+        }
+    }
+
+    void assign_raw(const int* sparse_in, size_t sparse_count, const int* entities, size_t entity_count,
+                    const void* dense_in, size_t dense_count) override {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            sparse.assign_bytes(sparse_in, sparse_count);
+            entity_map.assign_bytes(entities, entity_count);
+            dense.assign_bytes(dense_in, dense_count);
+        } else {
+            throw std::logic_error("ComponentPool::assign_raw: component is not trivially copyable");
+        }
+    }
+
+    // Permute the packed arrays so the listed entities come first, in the given
+    // order; every other entry keeps its relative order after them. Entities in
+    // `order` must be present in the pool.
+    void reorder(const std::vector<int>& order) {
+        std::vector<int> src;
+        src.reserve(dense.size());
+        std::vector<char> placed(dense.size(), 0);
+        for (int entity : order) {
+            src.push_back(sparse[entity]);
+            placed[sparse[entity]] = 1;
+        }
+        for (int idx = 0; idx < (int)dense.size(); ++idx)
+            if (!placed[idx]) src.push_back(idx);
+
+        std::vector<int> new_map(src.size());
+        std::vector<T>   new_dense;
+        new_dense.reserve(src.size());
+        for (size_t i = 0; i < src.size(); ++i) {
+            new_map[i] = entity_map[src[i]];
+            new_dense.push_back(std::move(dense[src[i]]));
+        }
+        // Only live entries are re-pointed; stale duplicates from repeated assign() stay orphaned
+        std::vector<char> live(src.size());
+        for (size_t i = 0; i < src.size(); ++i) live[i] = sparse[new_map[i]] == src[i];
+        for (size_t i = 0; i < src.size(); ++i)
+            if (live[i]) sparse[new_map[i]] = static_cast<int>(i);
+        entity_map = PoolArray<int>(std::move(new_map));
+        dense      = PoolArray<T>(std::move(new_dense));
+    }
 };
 
+namespace detail {
+    // Snapshot file layout: header, one directory entry per pool, then each
+    // pool's sparse / entity_map / dense arrays as raw sections, every section
+    // starting on a kSnapshotAlign boundary so it can be used in place.
+    inline constexpr char          kSnapshotMagic[8] = {'D','A','L','S','N','A','P','1'};
+    inline constexpr std::uint32_t kSnapshotVersion  = 1;
+    inline constexpr std::uint64_t kSnapshotAlign    = 64;
+
+    struct SnapshotHeader {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t pool_count;
+    };
+
+    struct SnapshotPoolEntry {
+        std::uint64_t type_key;
+        std::uint32_t component_size;
+        std::uint32_t component_align;
+        std::uint64_t sparse_offset,   sparse_count;
+        std::uint64_t entities_offset, entities_count;
+        std::uint64_t dense_offset,    dense_count;
+    };
+
+    inline std::uint64_t align_up(std::uint64_t n) {
+        return (n + kSnapshotAlign - 1) / kSnapshotAlign * kSnapshotAlign;
+    }
+
+    // Whether `count` elements of `elem` bytes at `offset` fit in a file of
+    // `size` bytes; written so that no value read from the file can overflow
+    inline bool section_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t elem, std::uint64_t size) {
+        return offset <= size && count <= (size - offset) / elem;
+    }
+
+    // Every value of an int section lies in [lo, hi)
+    inline bool ints_in_range(const std::byte* p, std::uint64_t count, std::int64_t lo, std::int64_t hi) {
+        const int* v = reinterpret_cast<const int*>(p);
+        return std::all_of(v, v + count, [&](int x) { return x >= lo && x < hi; });
+    }
+}
+
 class Registry {
     std::unordered_map<int, std::unique_ptr<BasePool>> pools;
+    std::unordered_map<int, std::unique_ptr<BaseResource>> resources;
+
+    // view() resolves each requested type to its storage once, before the loop
+    template <typename C>
+    ComponentPool<C>& view_store(std::type_identity<C>) { return get_pool<C>(); }
+    template <typename T>
+    T& view_store(std::type_identity<Resource<T>>) { return resource<T>(); }
+
+    template <typename C>
+    static bool view_has(ComponentPool<C>& pool, int entity) { return pool.contains(entity); }
+    template <typename T>
+    static bool view_has(T&, int) { return true; }
+
+    template <typename C>
+    static C& view_get(ComponentPool<C>& pool, int entity) { return pool.get(entity); }
+    template <typename T>
+    static T& view_get(T& res, int) { return res; }
+
 public:
     template <typename T>
     ComponentPool<T>& get_pool() {
@@ -52,15 +366,166 @@ public:
         return *static_cast<ComponentPool<T>*>(pools[id].get());
     }
 
+    // Singleton storage for global state (gravity, timestep, ...) that is not
+    // attached to any entity. set_resource constructs (or replaces) the value;
+    // resource() default-constructs it on first access when T allows that, and
+    // throws std::out_of_range for a missing resource that cannot be.
+    template <typename T, typename... Args>
+    T& set_resource(Args&&... args) {
+        auto& slot = resources[TypeRegistry::get_id<T>()];
+        slot = std::make_unique<ResourceSlot<T>>(std::forward<Args>(args)...);
+        return static_cast<ResourceSlot<T>*>(slot.get())->value;
+    }
+
+    template <typename T>
+    T& resource() {
+        auto it = resources.find(TypeRegistry::get_id<T>());
+        if (it == resources.end()) {
+            if constexpr (std::is_default_constructible_v<T>) return set_resource<T>();
+            else throw std::out_of_range("Registry::resource: resource was never set");
+        }
+        return static_cast<ResourceSlot<T>*>(it->second.get())->value;
+    }
+
+    template <typename T>
+    bool has_resource() const { return resources.count(TypeRegistry::get_id<T>()) != 0; }
+
+    template <typename Func>
+    void for_each_pool(Func&& func) {
+        for (auto& [id, pool] : pools) func(id, *pool);
+    }
+
+    // Write every pool's sparse, entity_map and dense arrays to `path` as
+    // aligned raw sections. All components must be trivially copyable.
+    void snapshot(const std::string& path) const {
+        std::vector<const BasePool*> list;
+        for (const auto& [id, pool] : pools) {
+            if (!pool->trivially_copyable())
+                throw std::logic_error("Registry::snapshot: component is not trivially copyable");
+            list.push_back(pool.get());
+        }
+
+        detail::SnapshotHeader header{};
+        std::memcpy(header.magic, detail::kSnapshotMagic, sizeof header.magic);
+        header.version    = detail::kSnapshotVersion;
+        header.pool_count = static_cast<std::uint32_t>(list.size());
+
+        std::vector<detail::SnapshotPoolEntry> dir(list.size());
+        std::uint64_t offset = detail::align_up(sizeof header + dir.size() * sizeof(detail::SnapshotPoolEntry));
+        for (size_t i = 0; i < list.size(); ++i) {
+            const BasePool& p = *list[i];
+            auto& e = dir[i];
+            e.type_key        = p.type_key();
+            e.component_size  = static_cast<std::uint32_t>(p.component_size());
+            e.component_align = static_cast<std::uint32_t>(p.component_align());
+            e.sparse_count    = p.sparse_array().size();
+            e.entities_count  = p.entity_array().size();
+            e.dense_count     = p.size();
+            e.sparse_offset   = offset; offset = detail::align_up(offset + e.sparse_count   * sizeof(int));
+            e.entities_offset = offset; offset = detail::align_up(offset + e.entities_count * sizeof(int));
+            e.dense_offset    = offset; offset = detail::align_up(offset + e.dense_count    * e.component_size);
+        }
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Registry::snapshot: cannot open " + path);
+        std::uint64_t pos = 0;
+        auto put = [&](const void* data, std::uint64_t bytes) {
+            out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            pos += bytes;
+        };
+        auto pad_to = [&](std::uint64_t target) {
+            static const char zeros[detail::kSnapshotAlign] = {};
+            put(zeros, target - pos);
+        };
+        put(&header, sizeof header);
+        put(dir.data(), dir.size() * sizeof(detail::SnapshotPoolEntry));
+        for (size_t i = 0; i < list.size(); ++i) {
+            const BasePool& p = *list[i];
+            const auto& e = dir[i];
+            pad_to(e.sparse_offset);   put(p.sparse_array().data(), e.sparse_count   * sizeof(int));
+            pad_to(e.entities_offset); put(p.entity_array().data(), e.entities_count * sizeof(int));
+            pad_to(e.dense_offset);    put(p.dense_data(),          e.dense_count    * e.component_size);
+        }
+        pad_to(offset);
+        if (!out) throw std::runtime_error("Registry::snapshot: write failed for " + path);
+    }
+
+    // Replace the registry's component state with the snapshot at `path`. The
+    // file is mapped and pools view their sections in place — no per-component
+    // copy. Every pool in the file needs a matching pool in this registry;
+    // list the component types to create them, e.g. restore<Position, Mass>(path).
+    // Pools absent from the file are cleared. Resources are not part of snapshots.
+    template <typename... Components>
+    void restore(const std::string& path) {
+        (get_pool<Components>(), ...);
+
+        size_t size = 0;
+        std::shared_ptr<void> file = detail::map_file(path, size);
+        auto* base = static_cast<std::byte*>(file.get());
+
+        detail::SnapshotHeader header;
+        if (size < sizeof header) throw std::runtime_error("Registry::restore: truncated snapshot " + path);
+        std::memcpy(&header, base, sizeof header);
+        if (std::memcmp(header.magic, detail::kSnapshotMagic, sizeof header.magic) != 0 ||
+            header.version != detail::kSnapshotVersion)
+            throw std::runtime_error("Registry::restore: not a snapshot file " + path);
+        if (size < sizeof header + header.pool_count * sizeof(detail::SnapshotPoolEntry))
+            throw std::runtime_error("Registry::restore: truncated snapshot " + path);
+
+        std::unordered_map<std::uint64_t, BasePool*> by_key;
+        for (auto& [id, pool] : pools) by_key[pool->type_key()] = pool.get();
+
+        // Validate everything before touching any pool
+        std::vector<std::pair<BasePool*, detail::SnapshotPoolEntry>> plan;
+        for (std::uint32_t i = 0; i < header.pool_count; ++i) {
+            detail::SnapshotPoolEntry e;
+            std::memcpy(&e, base + sizeof header + i * sizeof e, sizeof e);
+            auto it = by_key.find(e.type_key);
+            if (it == by_key.end())
+                throw std::runtime_error("Registry::restore: snapshot has a pool of an unregistered component type");
+            if (it->second->component_size() != e.component_size)
+                throw std::runtime_error("Registry::restore: component size mismatch");
+            // Components are used in place, so the writer's alignment must be
+            // this build's and the dense section must honour it
+            if (it->second->component_align() != e.component_align)
+                throw std::runtime_error("Registry::restore: component alignment mismatch");
+            if (e.dense_offset % e.component_align != 0)
+                throw std::runtime_error("Registry::restore: corrupt snapshot " + path);
+            if (!detail::section_fits(e.sparse_offset,   e.sparse_count,   sizeof(int),      size) ||
+                !detail::section_fits(e.entities_offset, e.entities_count, sizeof(int),      size) ||
+                !detail::section_fits(e.dense_offset,    e.dense_count,    e.component_size, size))
+                throw std::runtime_error("Registry::restore: truncated snapshot " + path);
+            // The pool indexes through these arrays unchecked: sparse holds dense
+            // indices or -1, entity_map holds indices into sparse
+            if (e.entities_count != e.dense_count ||
+                e.sparse_offset % alignof(int) != 0 || e.entities_offset % alignof(int) != 0 ||
+                !detail::ints_in_range(base + e.sparse_offset, e.sparse_count, -1, std::int64_t(e.dense_count)) ||
+                !detail::ints_in_range(base + e.entities_offset, e.entities_count, 0, std::int64_t(e.sparse_count)))
+                throw std::runtime_error("Registry::restore: corrupt snapshot " + path);
+            plan.emplace_back(it->second, e);
+        }
+
+        for (auto& [id, pool] : pools) pool->clear();
+        for (auto& [pool, e] : plan) {
+            pool->adopt(reinterpret_cast<int*>(base + e.sparse_offset),   e.sparse_count,
+                        reinterpret_cast<int*>(base + e.entities_offset), e.entities_count,
+                        base + e.dense_offset, e.dense_count, file);
+        }
+    }
+
     template <typename... Components, typename Func>
     void view(Func&& func) {
         using LeaderType = std::tuple_element_t<0, std::tuple<Components...>>;
-        auto& leader_pool = get_pool<LeaderType>();
+        static_assert(!is_resource_v<LeaderType>, "view: the leader must be a component, not a Resource<T>");
+        auto stores = std::forward_as_tuple(view_store(std::type_identity<Components>{})...);
+        auto& leader_pool = std::get<0>(stores);
 
         for (int entity : leader_pool.entities()) {
-            if ((get_pool<Components>().contains(entity) && ...)) {
-                func(get_pool<Components>().get(entity)...);
-            }
+            std::apply([&](auto&... store) {
+                if ((view_has(store, entity) && ...)) {
+                    func(view_get(store, entity)...);
+                }
+            }, stores);
         }
     }
-};
\ No newline at end of file
+};
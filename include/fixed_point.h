@@ -0,0 +1,101 @@
+#pragma once
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+// Binary fixed-point number: `raw` holds value · 2^FracBits. Intended as a
+// Quantity representation where storage must be compact or bit-exact across
+// platforms, e.g. Quantity<Length::DimensionType, FixedPoint<16>>.
+//
+// Construction from any arithmetic value is implicit (rounding to nearest).
+// Conversion back out is explicit. A scalar times a FixedPoint quantity is
+// computed in their std::common_type (see below): an integer keeps the
+// quantity fixed-point, while a float or double gives a quantity of that
+// floating-point type.
+template <int FracBits, typename Int = std::int64_t>
+struct FixedPoint {
+    static_assert(std::is_integral_v<Int> && std::is_signed_v<Int>, "FixedPoint: Int must be a signed integer");
+    static_assert(FracBits > 0 && FracBits < int(sizeof(Int) * 8) - 1, "FixedPoint: FracBits out of range");
+
+    static constexpr Int one = Int(1) << FracBits;
+    Int raw = 0;
+
+    constexpr FixedPoint() = default;
+
+    template <typename A>
+        requires std::is_arithmetic_v<A>
+    constexpr FixedPoint(A v) {
+        if constexpr (std::is_floating_point_v<A>)
+            raw = static_cast<Int>(v * one + (v < 0 ? A(-0.5) : A(0.5)));
+        else
+            raw = static_cast<Int>(v) * one;
+    }
+
+    static constexpr FixedPoint from_raw(Int r) {
+        FixedPoint f;
+        f.raw = r;
+        return f;
+    }
+
+    template <typename A>
+        requires std::is_arithmetic_v<A>
+    explicit constexpr operator A() const {
+        if constexpr (std::is_floating_point_v<A>) return static_cast<A>(raw) / one;
+        else                                       return static_cast<A>(raw / one);
+    }
+
+    constexpr FixedPoint operator+(FixedPoint r) const { return from_raw(raw + r.raw); }
+    constexpr FixedPoint operator-(FixedPoint r) const { return from_raw(raw - r.raw); }
+    constexpr FixedPoint operator-() const { return from_raw(-raw); }
+
+    // Products and quotients go through a double-width intermediate
+    constexpr FixedPoint operator*(FixedPoint r) const {
+        return from_raw(static_cast<Int>((static_cast<Wide>(raw) * r.raw) >> FracBits));
+    }
+    constexpr FixedPoint operator/(FixedPoint r) const {
+        return from_raw(static_cast<Int>(static_cast<Wide>(raw) * one / r.raw));
+    }
+
+    constexpr auto operator<=>(const FixedPoint&) const = default;
+
+private:
+#if defined(__SIZEOF_INT128__)
+    using Wide = std::conditional_t<(sizeof(Int) < 8), std::int64_t, __int128>;
+#else
+    static_assert(sizeof(Int) < 8, "FixedPoint: 64-bit storage needs a 128-bit integer type");
+    using Wide = std::int64_t;
+#endif
+};
+
+// abs, sqrt, cbrt and pow(x, e) are found by ADL from the Quantity math
+// functions, the last two for rational powers pow<P, Q>; pow<N> needs only
+// the multiplication operator. Roots and real powers go through double.
+template <int F, typename I>
+constexpr FixedPoint<F, I> abs(FixedPoint<F, I> x) { return x.raw < 0 ? -x : x; }
+
+template <int F, typename I>
+FixedPoint<F, I> sqrt(FixedPoint<F, I> x) { return FixedPoint<F, I>(std::sqrt(static_cast<double>(x))); }
+
+template <int F, typename I>
+FixedPoint<F, I> cbrt(FixedPoint<F, I> x) { return FixedPoint<F, I>(std::cbrt(static_cast<double>(x))); }
+
+template <int F, typename I>
+FixedPoint<F, I> pow(FixedPoint<F, I> x, double e) { return FixedPoint<F, I>(std::pow(static_cast<double>(x), e)); }
+
+template <int F, typename I>
+std::ostream& operator<<(std::ostream& os, FixedPoint<F, I> x) { return os << static_cast<double>(x); }
+
+// Mixed with a floating-point type, compute in floating point; mixed with an
+// integer, stay fixed-point.
+template <int F, typename I, typename A>
+    requires std::is_arithmetic_v<A>
+struct std::common_type<FixedPoint<F, I>, A> {
+    using type = std::conditional_t<std::is_floating_point_v<A>, A, FixedPoint<F, I>>;
+};
+template <int F, typename I, typename A>
+    requires std::is_arithmetic_v<A>
+struct std::common_type<A, FixedPoint<F, I>> {
+    using type = std::conditional_t<std::is_floating_point_v<A>, A, FixedPoint<F, I>>;
+};
@@ -0,0 +1,141 @@
+#pragma once
+#include "ecs.h"
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+// Parent/child relationships between entities, laid out breadth-first: every
+// parent precedes its children and each node's children are contiguous. A pool
+// sorted into this order can be propagated root-to-leaf in one linear sweep.
+class Hierarchy {
+    static constexpr int kAbsent = -2;
+    static constexpr int kRoot   = -1;
+
+    std::vector<int> parent_of;   // sparse by entity: parent entity, kRoot or kAbsent
+    std::vector<int> members;     // insertion order; roots and siblings keep it in bfs
+
+    // Breadth-first layout, rebuilt lazily after a structural change
+    std::vector<int> bfs;          // entity at each position
+    std::vector<int> parent_pos;   // position of the parent, -1 for roots
+    std::vector<int> child_begin;  // position of the first child
+    std::vector<int> child_count;
+    std::vector<int> pos_of;       // sparse by entity: position in bfs
+    bool dirty = false;
+
+    void ensure(int entity) {
+        if (entity >= (int)parent_of.size()) parent_of.resize(entity + 1, kAbsent);
+        if (parent_of[entity] == kAbsent) {
+            parent_of[entity] = kRoot;
+            members.push_back(entity);
+        }
+        dirty = true;
+    }
+
+    void rebuild() {
+        // Children of each entity, packed (CSR) in insertion order
+        std::vector<int> offset(parent_of.size() + 1, 0);
+        for (int e : members)
+            if (parent_of[e] >= 0) ++offset[parent_of[e] + 1];
+        for (size_t i = 1; i < offset.size(); ++i) offset[i] += offset[i - 1];
+        std::vector<int> kids(offset.back());
+        std::vector<int> fill(offset.begin(), offset.end() - 1);
+        for (int e : members)
+            if (parent_of[e] >= 0) kids[fill[parent_of[e]]++] = e;
+
+        const size_t n = members.size();
+        bfs.clear();         bfs.reserve(n);
+        parent_pos.clear();  parent_pos.reserve(n);
+        child_begin.assign(n, 0);
+        child_count.assign(n, 0);
+        pos_of.assign(parent_of.size(), -1);
+        for (int e : members) {
+            if (parent_of[e] != kRoot) continue;
+            bfs.push_back(e);
+            parent_pos.push_back(-1);
+        }
+        for (size_t i = 0; i < bfs.size(); ++i) {
+            const int e = bfs[i];
+            pos_of[e]      = static_cast<int>(i);
+            child_begin[i] = static_cast<int>(bfs.size());
+            child_count[i] = offset[e + 1] - offset[e];
+            for (int k = offset[e]; k < offset[e + 1]; ++k) {
+                bfs.push_back(kids[k]);
+                parent_pos.push_back(static_cast<int>(i));
+            }
+        }
+        dirty = false;
+    }
+
+public:
+    // Make `child` a child of `parent`, adding either as needed. Re-attaching
+    // moves the child (with its subtree); creating a cycle throws.
+    void attach(int child, int parent) {
+        if (child == parent) throw std::invalid_argument("Hierarchy::attach: entity cannot parent itself");
+        for (int a = parent; a >= 0 && a < (int)parent_of.size(); a = parent_of[a])
+            if (a == child) throw std::invalid_argument("Hierarchy::attach: would create a cycle");
+        ensure(parent);
+        ensure(child);
+        parent_of[child] = parent;
+    }
+
+    void add_root(int entity) {
+        ensure(entity);
+        parent_of[entity] = kRoot;
+    }
+
+    // Remove an entity; its children become roots.
+    void detach(int entity) {
+        if (!contains(entity)) return;
+        for (int e : members)
+            if (parent_of[e] == entity) parent_of[e] = kRoot;
+        parent_of[entity] = kAbsent;
+        members.erase(std::find(members.begin(), members.end(), entity));
+        dirty = true;
+    }
+
+    bool contains(int entity) const {
+        return entity >= 0 && entity < (int)parent_of.size() && parent_of[entity] != kAbsent;
+    }
+    // Parent entity, or -1 for a root; std::out_of_range for a non-member
+    int parent(int entity) const {
+        if (!contains(entity)) throw std::out_of_range("Hierarchy::parent: entity not in hierarchy");
+        return parent_of[entity];
+    }
+    size_t size() const { return members.size(); }
+
+    // Breadth-first entity order
+    const std::vector<int>& order() {
+        if (dirty) rebuild();
+        return bfs;
+    }
+
+    // Children in order(); std::out_of_range for a non-member
+    std::span<const int> children(int entity) {
+        if (!contains(entity)) throw std::out_of_range("Hierarchy::children: entity not in hierarchy");
+        if (dirty) rebuild();
+        const int p = pos_of[entity];
+        return std::span<const int>(bfs).subspan(child_begin[p], child_count[p]);
+    }
+
+    // Reorder `pool` so its first size() entries follow order(). Every entity in
+    // the hierarchy must have a component in the pool.
+    template <typename T>
+    void sort(ComponentPool<T>& pool) {
+        for (int e : order())
+            if (!pool.contains(e)) throw std::invalid_argument("Hierarchy::sort: entity missing from pool");
+        pool.reorder(bfs);
+    }
+
+    // Call func(const T& parent, T& child) for every non-root entity, parents
+    // before children. Sorts the pool first if it is not already in order().
+    template <typename T, typename Func>
+    void propagate(ComponentPool<T>& pool, Func&& func) {
+        const auto& ord = order();
+        const auto& ents = pool.entities();
+        if (ents.size() < ord.size() || !std::equal(ord.begin(), ord.end(), ents.begin())) sort(pool);
+
+        auto& data = pool.components();
+        for (size_t i = 0; i < ord.size(); ++i)
+            if (parent_pos[i] >= 0) func(std::as_const(data[parent_pos[i]]), data[i]);
+    }
+};
@@ -0,0 +1,180 @@
+#pragma once
+#include "quantity_reduce.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Threshold filters over quantity columns: which elements satisfy
+// `x > 350.0_K`?
+//
+//     auto hot = select_indices(t, std::greater<>{}, 350.0_K);   // std::vector<std::uint32_t>
+//     auto low = select_bitmap(p, std::less<>{}, 1.0_atm);       // bit i of word i / 64
+//
+// The column is any range the reductions take (quantity_reduce.h): a vector,
+// a QuantityVector, a span, or a vector expression evaluated on the fly. The
+// threshold must have the column's dimension, so comparing a Pressure column
+// with a Temperature does not compile. Comparisons mean what they do on
+// Quantity: a NaN element satisfies only std::not_equal_to.
+//
+// std::less<>, less_equal<>, greater<>, greater_equal<>, equal_to<> and
+// not_equal_to<> compare a whole simd::Pack at once and turn the result into
+// bits (one movemask on x86), 64 elements to a word, with no branch per
+// element. A selection vector is decoded from those words: one set bit at a
+// time when a word is sparse, through a 256-entry table of bit positions,
+// eight elements per step, when it is dense. Any other predicate,
+// called as cmp(element, threshold), runs one element at a time.
+
+namespace detail {
+    template <typename Cmp>
+    inline constexpr bool has_compare_kernel_v =
+        std::is_same_v<Cmp, std::less<>> || std::is_same_v<Cmp, std::less_equal<>> ||
+        std::is_same_v<Cmp, std::greater<>> || std::is_same_v<Cmp, std::greater_equal<>> ||
+        std::is_same_v<Cmp, std::equal_to<>> || std::is_same_v<Cmp, std::not_equal_to<>>;
+
+    template <typename Cmp, typename T, int N>
+    unsigned compare_bits(simd::Pack<T, N> x, simd::Pack<T, N> t) {
+        if constexpr (std::is_same_v<Cmp, std::less<>>)          return simd::lt_bits(x, t);
+        if constexpr (std::is_same_v<Cmp, std::less_equal<>>)    return simd::le_bits(x, t);
+        if constexpr (std::is_same_v<Cmp, std::greater<>>)       return simd::lt_bits(t, x);
+        if constexpr (std::is_same_v<Cmp, std::greater_equal<>>) return simd::le_bits(t, x);
+        if constexpr (std::is_same_v<Cmp, std::equal_to<>>)      return simd::eq_bits(x, t);
+        if constexpr (std::is_same_v<Cmp, std::not_equal_to<>>)
+            return ~simd::eq_bits(x, t) & unsigned((std::uint64_t(1) << N) - 1);
+    }
+
+    // f(word, bits) for each 64-element word of the column, in order
+    template <typename S, typename Cmp, typename F>
+    void for_each_match_word(const S& s, Cmp cmp, typename S::value_type t, F f) {
+        using T = source_rep_t<S>;
+        const std::size_t n = s.size();
+        std::size_t base = 0;
+        if constexpr (S::vectorizable && has_compare_kernel_v<Cmp>) {
+            constexpr int N = simd::kNativeLanes<T>;
+            using P = simd::Pack<T, N>;
+            const P tp(t.value);
+            for (; base + 64 <= n; base += 64) {
+                std::uint64_t bits = 0;
+                for (int j = 0; j < 64; j += N)
+                    bits |= std::uint64_t(compare_bits<Cmp>(s.template pack<N>(base + j).value, tp)) << j;
+                f(base / 64, bits);
+            }
+        }
+        for (; base < n; base += 64) {
+            std::uint64_t bits = 0;
+            const std::size_t end = std::min(n, base + 64);
+            for (std::size_t i = base; i < end; ++i)
+                bits |= std::uint64_t(bool(cmp(s[i], t))) << (i - base);
+            f(base / 64, bits);
+        }
+    }
+
+    // Positions of the set bits of each byte value, padded to eight
+    struct ByteBitPositions {
+        std::uint8_t at[256][8];
+    };
+    inline constexpr ByteBitPositions kByteBitPositions = [] {
+        ByteBitPositions t{};
+        for (int b = 0; b < 256; ++b) {
+            int k = 0;
+            for (int i = 0; i < 8; ++i)
+                if (b >> i & 1) t.at[b][k++] = std::uint8_t(i);
+        }
+        return t;
+    }();
+
+    // Append base + i for each set bit i. A sparse word visits its set bits;
+    // a dense one writes eight candidates per byte and advances by the
+    // byte's popcount, which may write up to eight slots past the last index
+    // kept, so callers leave that much room.
+    inline std::uint32_t* append_indices(std::uint32_t* p, std::size_t base, std::uint64_t bits) {
+        if (std::popcount(bits) < 16) {
+            for (; bits; bits &= bits - 1) *p++ = std::uint32_t(base + std::size_t(std::countr_zero(bits)));
+            return p;
+        }
+        for (int byte = 0; byte < 8; ++byte, bits >>= 8, base += 8) {
+            const unsigned b = unsigned(bits & 0xff);
+            const std::uint8_t* at = kByteBitPositions.at[b];
+            for (int k = 0; k < 8; ++k) p[k] = std::uint32_t(base + at[k]);
+            p += std::popcount(b);
+        }
+        return p;
+    }
+
+    inline void check_index_range(std::size_t n) {
+        if (n > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("select_indices: column too long for 32-bit indices");
+    }
+
+    // Every bit of a bitmap of `words` words has a 32-bit index; the last
+    // one is words · 64 − 1
+    inline void check_bitmap_range(std::size_t words) {
+        if (words > std::numeric_limits<std::uint32_t>::max() / 64 + 1)
+            throw std::length_error("indices_of: bitmap too long for 32-bit indices");
+    }
+}
+
+// Words of a bitmap over n elements
+constexpr std::size_t bitmap_words(std::size_t n) { return (n + 63) / 64; }
+
+// Bit i % 64 of out[i / 64] set where cmp(col[i], threshold); bits past the
+// end of the column are clear. out must hold exactly bitmap_words(col.size())
+// words, or std::invalid_argument is thrown.
+template <QuantityRange R, typename Cmp>
+void select_bitmap(const R& col, Cmp cmp, const range_quantity_t<R>& threshold, std::span<std::uint64_t> out) {
+    decltype(auto) s = detail::reduce_source(col);
+    if (out.size() != bitmap_words(s.size())) throw std::invalid_argument("select_bitmap: size mismatch");
+    std::uint64_t* words = out.data();
+    detail::for_each_match_word(s, cmp, threshold, [&](std::size_t w, std::uint64_t bits) { words[w] = bits; });
+}
+
+template <QuantityRange R, typename Cmp>
+std::vector<std::uint64_t> select_bitmap(const R& col, Cmp cmp, const range_quantity_t<R>& threshold) {
+    std::vector<std::uint64_t> out(bitmap_words(detail::reduce_source(col).size()));
+    select_bitmap(col, cmp, threshold, std::span(out));
+    return out;
+}
+
+// Indices of the set bits of a bitmap, in increasing order
+inline std::vector<std::uint32_t> indices_of(std::span<const std::uint64_t> bitmap) {
+    detail::check_bitmap_range(bitmap.size());
+    std::size_t count = 0;
+    for (std::uint64_t w : bitmap) count += std::size_t(std::popcount(w));
+    std::vector<std::uint32_t> out(count + 8);              // room for append_indices
+    std::uint32_t* p = out.data();
+    for (std::size_t w = 0; w < bitmap.size(); ++w) p = detail::append_indices(p, w * 64, bitmap[w]);
+    out.resize(count);
+    return out;
+}
+
+// Indices i where cmp(col[i], threshold), in increasing order, written to
+// the front of out; returns how many. out must hold at least col.size()
+// indices, or std::invalid_argument is thrown; columns longer than 2^32 − 1
+// throw std::length_error.
+template <QuantityRange R, typename Cmp>
+std::size_t select_indices(const R& col, Cmp cmp, const range_quantity_t<R>& threshold, std::span<std::uint32_t> out) {
+    decltype(auto) s = detail::reduce_source(col);
+    detail::check_index_range(s.size());
+    if (out.size() < s.size()) throw std::invalid_argument("select_indices: output too small");
+    // No more indices than elements precede any byte, so within a full word
+    // out has the room append_indices needs; the last, partial word may not
+    const std::size_t full = s.size() / 64;
+    std::uint32_t* p = out.data();
+    detail::for_each_match_word(s, cmp, threshold, [&](std::size_t w, std::uint64_t bits) {
+        if (w < full) p = detail::append_indices(p, w * 64, bits);
+        else          for (; bits; bits &= bits - 1) *p++ = std::uint32_t(w * 64 + std::size_t(std::countr_zero(bits)));
+    });
+    return std::size_t(p - out.data());
+}
+
+// As a vector sized to the matches: the bitmap first, then its set bits
+template <QuantityRange R, typename Cmp>
+std::vector<std::uint32_t> select_indices(const R& col, Cmp cmp, const range_quantity_t<R>& threshold) {
+    detail::check_index_range(detail::reduce_source(col).size());
+    return indices_of(select_bitmap(col, cmp, threshold));
+}
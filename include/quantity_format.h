@@ -0,0 +1,151 @@
+#pragma once
+#include "dimensions.h"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <version>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+// Allocation-free, locale-free text output of quantities.
+//
+// to_chars(first, last, q) writes the value with std::to_chars followed by
+// the compile-time unit suffix (" [kg·m^2·s^-2]"), like operator<< but
+// without a stream, a heap allocation or the global locale. A
+// QuantityFormatSpec chooses the notation and precision.
+//
+// std::format("{}", q) and std::format("{:.3f}", q) use the same path when
+// the standard library provides <format>. The format spec is
+// [.precision][e|f|g|a][n], with the meaning std::format gives it for a
+// double; a trailing n prints the unit's name ("[J]", see UnitSymbol) where it
+// has one. The default is the shortest text that reads back as the same value.
+
+// Notation and precision for to_chars; the defaults give the shortest
+// round-trip representation
+struct QuantityFormatSpec {
+    char type      = 0;       // 0, 'e', 'f', 'g' or 'a'
+    int  precision = -1;      // -1 for none
+    bool named     = false;   // "[J]" rather than "[kg·m^2·s^-2]"
+};
+
+namespace detail {
+    inline constexpr int kMaxFormatPrecision = 1000;
+
+    // Upper bound on the text value_to_chars writes for Rep under any spec
+    // parse_quantity_spec accepts: every integer digit of the largest value,
+    // every leading zero of the smallest, the precision, and sign, point and
+    // exponent
+    template <typename Rep>
+    constexpr std::size_t max_value_chars() {
+        if constexpr (std::is_integral_v<Rep>) {
+            return std::numeric_limits<Rep>::digits10 + 3;
+        } else if constexpr (std::is_floating_point_v<Rep>) {
+            using L = std::numeric_limits<Rep>;
+            return std::size_t(L::max_exponent10) - L::min_exponent10 + L::max_digits10 + kMaxFormatPrecision + 16;
+        } else {
+            return max_value_chars<double>();
+        }
+    }
+
+    // Longest "value [unit]" text of Q, named or not
+    template <IsQuantity Q>
+    constexpr std::size_t max_quantity_chars() {
+        using D = typename Q::DimensionType;
+        return max_value_chars<typename Q::RepType>() +
+               std::max(unit_suffix<D>.view().size(), named_unit_suffix<D>.view().size());
+    }
+
+    // Parse "[.precision][e|f|g|a][n]" up to '}' or the end. Returns the
+    // position of the '}' (or last), or nullptr if the spec is malformed.
+    constexpr const char* parse_quantity_spec(const char* first, const char* last, QuantityFormatSpec& spec) {
+        const char* p = first;
+        if (p != last && *p == '.') {
+            ++p;
+            if (p == last || *p < '0' || *p > '9') return nullptr;
+            int precision = 0;
+            while (p != last && *p >= '0' && *p <= '9') {
+                precision = precision * 10 + (*p++ - '0');
+                if (precision > kMaxFormatPrecision) return nullptr;
+            }
+            spec.precision = precision;
+        }
+        if (p != last && (*p == 'e' || *p == 'f' || *p == 'g' || *p == 'a')) spec.type = *p++;
+        if (p != last && *p == 'n') {
+            spec.named = true;
+            ++p;
+        }
+        if (p != last && *p != '}') return nullptr;
+        return p;
+    }
+
+    constexpr std::chars_format chars_format_of(char type) {
+        switch (type) {
+            case 'e': return std::chars_format::scientific;
+            case 'f': return std::chars_format::fixed;
+            case 'a': return std::chars_format::hex;
+            default:  return std::chars_format::general;
+        }
+    }
+
+    template <typename Rep>
+    std::to_chars_result value_to_chars(char* first, char* last, Rep v, QuantityFormatSpec spec) {
+        if constexpr (std::is_integral_v<Rep>) {
+            return std::to_chars(first, last, v);
+        } else if constexpr (std::is_floating_point_v<Rep>) {
+            if (spec.type == 0 && spec.precision < 0) return std::to_chars(first, last, v);
+            if (spec.precision < 0)                   return std::to_chars(first, last, v, chars_format_of(spec.type));
+            return std::to_chars(first, last, v, chars_format_of(spec.type), spec.precision);
+        } else {
+            // FixedPoint and other representations that convert to double
+            return value_to_chars(first, last, static_cast<double>(v), spec);
+        }
+    }
+}
+
+// Write "value [unit]" into [first, last). On success ptr is one past the last
+// character written; if the range is too small ec is
+// std::errc::value_too_large and the contents of the range are unspecified.
+template<IsQuantity Q>
+    requires std::is_arithmetic_v<typename Q::RepType> ||
+             requires(typename Q::RepType r) { static_cast<double>(r); }
+std::to_chars_result to_chars(char* first, char* last, Q q, QuantityFormatSpec spec = {}) {
+    using D = typename Q::DimensionType;
+    const std::string_view suffix = spec.named ? detail::named_unit_suffix<D>.view() : detail::unit_suffix<D>.view();
+    std::to_chars_result r = detail::value_to_chars(first, last, q.value, spec);
+    if (r.ec != std::errc()) return r;
+    if (std::size_t(last - r.ptr) < suffix.size()) return {last, std::errc::value_too_large};
+    std::memcpy(r.ptr, suffix.data(), suffix.size());
+    return {r.ptr + suffix.size(), std::errc()};
+}
+
+#if defined(__cpp_lib_format)
+template<typename Dim, typename Rep>
+struct std::formatter<Quantity<Dim, Rep>, char> {
+    QuantityFormatSpec spec;
+
+    constexpr auto parse(std::format_parse_context& ctx) {
+        const char* first = std::to_address(ctx.begin());
+        const char* end   = detail::parse_quantity_spec(first, first + (ctx.end() - ctx.begin()), spec);
+        if (!end) throw std::format_error("invalid format spec for Quantity");
+        if (std::is_integral_v<Rep> && (spec.type || spec.precision >= 0))
+            throw std::format_error("integer Quantity takes no precision or type");
+        return ctx.begin() + (end - first);
+    }
+
+    template<typename FormatContext>
+    auto format(const Quantity<Dim, Rep>& q, FormatContext& ctx) const {
+        // Large enough for every spec parse accepts, so format cannot fail
+        char buffer[detail::max_quantity_chars<Quantity<Dim, Rep>>()];
+        const auto r = ::to_chars(buffer, buffer + sizeof buffer, q, spec);
+        if (r.ec != std::errc()) throw std::format_error("Quantity too long to format");
+        return std::copy(buffer, r.ptr, ctx.out());
+    }
+};
+#endif
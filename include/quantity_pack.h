@@ -0,0 +1,275 @@
+#pragma once
+#include "dimensions.h"
+#include <cmath>
+#include <cstring>
+#include <ostream>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// SIMD lanes as a Quantity representation.
+//
+// simd::Pack<T, N> holds N values of T in one vector register (or a group of
+// registers when N exceeds the native width). It behaves like an arithmetic
+// type with lane-wise operators, so QuantityPack<Dim, N> — a Quantity whose
+// Rep is a Pack — gets the full dimension algebra from Quantity itself:
+// Length-pack / Time-pack is a Velocity-pack, and adding a Mass-pack to it
+// does not compile.
+//
+// On GCC and Clang the lanes are a vector-extension type and the operators
+// compile to packed instructions for whatever ISA the translation unit
+// targets; sqrt uses SSE/AVX/NEON intrinsics where they exist. Other
+// compilers get a plain lane array and loops.
+
+namespace simd {
+
+#if defined(__GNUC__) || defined(__clang__)
+#define DAL_SIMD_VECTOR_EXT 1
+#else
+#define DAL_SIMD_VECTOR_EXT 0
+#endif
+
+    // Widest register available to this translation unit, in bytes
+#if defined(__AVX512F__)
+    inline constexpr int kRegisterBytes = 64;
+#elif defined(__AVX__)
+    inline constexpr int kRegisterBytes = 32;
+#else
+    inline constexpr int kRegisterBytes = 16;
+#endif
+
+    // Lanes of T in one native register — a sensible default N
+    template <typename T>
+    inline constexpr int kNativeLanes = kRegisterBytes / int(sizeof(T));
+
+    namespace detail {
+        // Fallback lane storage with element-wise operators
+        template <typename T, int N>
+        struct LaneArray {
+            T lane[N];
+            T&       operator[](int i)       { return lane[i]; }
+            const T& operator[](int i) const { return lane[i]; }
+#define DAL_SIMD_LANE_OP(op)                                                     \
+            friend LaneArray operator op(const LaneArray& a, const LaneArray& b) { \
+                LaneArray r;                                                     \
+                for (int i = 0; i < N; ++i) r.lane[i] = a.lane[i] op b.lane[i];  \
+                return r;                                                        \
+            }
+            DAL_SIMD_LANE_OP(+)
+            DAL_SIMD_LANE_OP(-)
+            DAL_SIMD_LANE_OP(*)
+            DAL_SIMD_LANE_OP(/)
+#undef DAL_SIMD_LANE_OP
+            friend LaneArray operator-(const LaneArray& a) {
+                LaneArray r;
+                for (int i = 0; i < N; ++i) r.lane[i] = -a.lane[i];
+                return r;
+            }
+        };
+    }
+
+    template <typename T, int N>
+    struct Pack {
+        static_assert(std::is_arithmetic_v<T>, "simd::Pack: lane type must be arithmetic");
+        static_assert(N > 0 && (N & (N - 1)) == 0, "simd::Pack: lane count must be a power of two");
+
+#if DAL_SIMD_VECTOR_EXT
+        typedef T Native __attribute__((vector_size(N * sizeof(T))));
+#else
+        using Native = detail::LaneArray<T, N>;
+#endif
+        using value_type = T;
+        static constexpr int size = N;
+
+        Native v;
+
+        Pack() : v{} {}
+        // Broadcast: implicit, so scalars mix with packs like they do with T
+        Pack(T s) {
+            for (int i = 0; i < N; ++i) v[i] = s;
+        }
+        static Pack from_native(const Native& n) {
+            Pack r;
+            r.v = n;
+            return r;
+        }
+
+        static Pack load(const T* p) {
+            Pack r;
+            std::memcpy(&r.v, p, sizeof(Native));
+            return r;
+        }
+        void store(T* p) const { std::memcpy(p, &v, sizeof(Native)); }
+
+        T operator[](int i) const { return v[i]; }
+        void set(int i, T s) { v[i] = s; }
+
+        Pack operator+(Pack o) const { return from_native(Native(v + o.v)); }
+        Pack operator-(Pack o) const { return from_native(Native(v - o.v)); }
+        Pack operator*(Pack o) const { return from_native(Native(v * o.v)); }
+        Pack operator/(Pack o) const { return from_native(Native(v / o.v)); }
+        Pack operator-() const { return from_native(Native(-v)); }
+    };
+
+    // Lane-wise; a lane where the comparison is false (NaN in b) keeps a.
+    // With vector extensions this is one compare-select, minpd/maxpd on x86.
+    template <typename T, int N>
+    Pack<T, N> min(Pack<T, N> a, Pack<T, N> b) {
+#if DAL_SIMD_VECTOR_EXT
+        return Pack<T, N>::from_native(b.v < a.v ? b.v : a.v);
+#else
+        Pack<T, N> r;
+        for (int i = 0; i < N; ++i) r.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i];
+        return r;
+#endif
+    }
+
+    template <typename T, int N>
+    Pack<T, N> max(Pack<T, N> a, Pack<T, N> b) {
+#if DAL_SIMD_VECTOR_EXT
+        return Pack<T, N>::from_native(a.v < b.v ? b.v : a.v);
+#else
+        Pack<T, N> r;
+        for (int i = 0; i < N; ++i) r.v[i] = a.v[i] < b.v[i] ? b.v[i] : a.v[i];
+        return r;
+#endif
+    }
+
+    namespace detail {
+        // A vector-extension compare result (all-ones or zero per lane) as
+        // one bit per lane; movemask where the register has one
+        template <typename T, int N, typename M>
+        unsigned lane_bits(M m) {
+#if DAL_SIMD_VECTOR_EXT && (defined(__SSE2__) || defined(_M_X64))
+            if constexpr (std::is_same_v<T, double> && N == 2) return unsigned(_mm_movemask_pd(__m128d(m)));
+            if constexpr (std::is_same_v<T, float>  && N == 4) return unsigned(_mm_movemask_ps(__m128(m)));
+#if defined(__AVX__)
+            if constexpr (std::is_same_v<T, double> && N == 4) return unsigned(_mm256_movemask_pd(__m256d(m)));
+            if constexpr (std::is_same_v<T, float>  && N == 8) return unsigned(_mm256_movemask_ps(__m256(m)));
+#endif
+#endif
+            unsigned bits = 0;
+            for (int i = 0; i < N; ++i) bits |= unsigned(m[i] != 0) << i;
+            return bits;
+        }
+    }
+
+    // Lane comparisons as an integer, bit i for lane i. A NaN lane compares
+    // false, as a scalar does; N may be at most 32.
+#if DAL_SIMD_VECTOR_EXT
+#define DAL_SIMD_COMPARE_BITS(name, op)                                          \
+    template <typename T, int N>                                                 \
+    unsigned name(Pack<T, N> a, Pack<T, N> b) {                                  \
+        static_assert(N <= 32);                                                  \
+        return detail::lane_bits<T, N>(a.v op b.v);                              \
+    }
+#else
+#define DAL_SIMD_COMPARE_BITS(name, op)                                          \
+    template <typename T, int N>                                                 \
+    unsigned name(Pack<T, N> a, Pack<T, N> b) {                                  \
+        static_assert(N <= 32);                                                  \
+        unsigned bits = 0;                                                       \
+        for (int i = 0; i < N; ++i) bits |= unsigned(a.v[i] op b.v[i]) << i;     \
+        return bits;                                                             \
+    }
+#endif
+    DAL_SIMD_COMPARE_BITS(lt_bits, <)
+    DAL_SIMD_COMPARE_BITS(le_bits, <=)
+    DAL_SIMD_COMPARE_BITS(eq_bits, ==)
+#undef DAL_SIMD_COMPARE_BITS
+
+    // Sum of all lanes
+    template <typename T, int N>
+    T reduce_add(Pack<T, N> a) {
+        T s = a.v[0];
+        for (int i = 1; i < N; ++i) s += a.v[i];
+        return s;
+    }
+
+    // abs, sqrt, cbrt and pow(a, e) are found by ADL from the Quantity math
+    // functions in dimensions.h; cbrt and pow serve rational powers pow<P, Q>
+
+    template <typename T, int N>
+    Pack<T, N> abs(Pack<T, N> a) {
+        Pack<T, N> r;
+        for (int i = 0; i < N; ++i) r.v[i] = a.v[i] < T(0) ? -a.v[i] : a.v[i];
+        return r;
+    }
+
+    template <typename T, int N>
+    Pack<T, N> sqrt(Pack<T, N> a) {
+#if DAL_SIMD_VECTOR_EXT && (defined(__SSE2__) || defined(_M_X64))
+        if constexpr (std::is_same_v<T, double> && N == 2) return Pack<T, N>::from_native(typename Pack<T, N>::Native(_mm_sqrt_pd(__m128d(a.v))));
+        if constexpr (std::is_same_v<T, float>  && N == 4) return Pack<T, N>::from_native(typename Pack<T, N>::Native(_mm_sqrt_ps(__m128(a.v))));
+#if defined(__AVX__)
+        if constexpr (std::is_same_v<T, double> && N == 4) return Pack<T, N>::from_native(typename Pack<T, N>::Native(_mm256_sqrt_pd(__m256d(a.v))));
+        if constexpr (std::is_same_v<T, float>  && N == 8) return Pack<T, N>::from_native(typename Pack<T, N>::Native(_mm256_sqrt_ps(__m256(a.v))));
+#endif
+#if defined(__AVX512F__)
+        if constexpr (std::is_same_v<T, double> && N == 8)  return Pack<T, N>::from_native(typename Pack<T, N>::Native(_mm512_sqrt_pd(__m512d(a.v))));
+        if constexpr (std::is_same_v<T, float>  && N == 16) return Pack<T, N>::from_native(typename Pack<T, N>::Native(_mm512_sqrt_ps(__m512(a.v))));
+#endif
+#elif DAL_SIMD_VECTOR_EXT && defined(__aarch64__) && defined(__ARM_NEON)
+        if constexpr (std::is_same_v<T, double> && N == 2) return Pack<T, N>::from_native(typename Pack<T, N>::Native(vsqrtq_f64(float64x2_t(a.v))));
+        if constexpr (std::is_same_v<T, float>  && N == 4) return Pack<T, N>::from_native(typename Pack<T, N>::Native(vsqrtq_f32(float32x4_t(a.v))));
+#endif
+        Pack<T, N> r;
+        for (int i = 0; i < N; ++i) r.v[i] = static_cast<T>(std::sqrt(a.v[i]));
+        return r;
+    }
+
+    // No vector instruction for these; one libm call per lane
+    template <typename T, int N>
+    Pack<T, N> cbrt(Pack<T, N> a) {
+        Pack<T, N> r;
+        for (int i = 0; i < N; ++i) r.v[i] = static_cast<T>(std::cbrt(a.v[i]));
+        return r;
+    }
+
+    template <typename T, int N>
+    Pack<T, N> pow(Pack<T, N> a, double e) {
+        Pack<T, N> r;
+        for (int i = 0; i < N; ++i) r.v[i] = static_cast<T>(std::pow(a.v[i], e));
+        return r;
+    }
+
+    template <typename T, int N>
+    std::ostream& operator<<(std::ostream& os, Pack<T, N> a) {
+        os << '{';
+        for (int i = 0; i < N; ++i) os << (i ? ", " : "") << a.v[i];
+        return os << '}';
+    }
+}
+
+// N lanes of Quantity<Dim, T>. Mixing with a scalar Quantity broadcasts it.
+template <typename Dim, int N = simd::kNativeLanes<double>, typename T = double>
+using QuantityPack = Quantity<Dim, simd::Pack<T, N>>;
+
+// Load N consecutive quantities into a pack (no alignment requirement)
+template <int N, typename Dim, typename T>
+QuantityPack<Dim, N, T> load_pack(const Quantity<Dim, T>* p) {
+    static_assert(sizeof(Quantity<Dim, T>) == sizeof(T));
+    return QuantityPack<Dim, N, T>(simd::Pack<T, N>::load(&p->value));
+}
+
+template <typename Dim, int N, typename T>
+void store_pack(const QuantityPack<Dim, N, T>& q, Quantity<Dim, T>* p) {
+    static_assert(sizeof(Quantity<Dim, T>) == sizeof(T));
+    q.value.store(&p->value);
+}
+
+// Lane i as a scalar quantity
+template <typename Dim, int N, typename T>
+Quantity<Dim, T> lane(const QuantityPack<Dim, N, T>& q, int i) {
+    return Quantity<Dim, T>(q.value[i]);
+}
+
+// Sum of all lanes as a scalar quantity
+template <typename Dim, int N, typename T>
+Quantity<Dim, T> reduce_add(const QuantityPack<Dim, N, T>& q) {
+    return Quantity<Dim, T>(simd::reduce_add(q.value));
+}
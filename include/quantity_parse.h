@@ -0,0 +1,397 @@
+#pragma once
+#include "dyn_quantity.h"
+#include "unit_convert.h"
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+// Text to quantities: "9.81 m/s^2", "3 kWh", "72 degF", "1.5 [kg·m^2·s^-2]".
+//
+// parse_quantity(first, last, q) behaves like std::from_chars: it reads a
+// number, then a unit expression, converts to SI and returns the position
+// after the last character it used. parse_quantity(first, last, Q&) also
+// checks the dimension against Q; parse_quantity(first, last, DynQuantity&)
+// returns whatever dimension the text spells. Nothing allocates, throws or
+// consults the locale; the string_view overloads wrap these and throw.
+//
+// Unit expressions:
+//
+//   unit := term { sep term }       sep: '·', '*', '/', or spaces before a symbol
+//   term := symbol [exp] | '(' unit ')' [exp] | '1'   ('1' first only, as in "[1]")
+//   exp  := '^' int | '^(' int [ '/' int ] ')'
+//
+// A symbol is the name of any literal in units.h without the underscore
+// (kg, kWh, psi, Mbps, ...), the same with µ or μ for a leading u, Ω for ohm,
+// and kat, count, °C and °F. '/' divides by the next term only, so W/m^2/K is
+// W·m^-2·K^-1; use parentheses for J/(kg·K). The temperature scales degC and
+// degF are affine and only stand alone. The unit may sit in brackets, so the
+// output of operator<< and to_chars reads back unchanged.
+//
+// Symbols are found with a perfect hash computed at compile time: the symbol's
+// bytes (at most eight) form a 64-bit key, and a multiplier found by search
+// sends every key to its own slot in a 4096-entry index. A lookup is a
+// multiply, a shift, two loads and one compare.
+
+namespace detail {
+    struct ParseSymbol {
+        std::uint64_t key;              // the symbol's bytes, first byte lowest, zero padded
+        double        factor;           // si = value · factor + offset
+        double        offset;
+        DimCodes      dims;             // of the SI unit
+    };
+
+    // Bytes of a then b packed into a lookup key
+    constexpr std::uint64_t symbol_key(std::string_view a, std::string_view b = {}) {
+        if (a.size() + b.size() == 0 || a.size() + b.size() > 8) throw "parse_quantity: symbol must be 1 to 8 bytes";
+        std::uint64_t k = 0;
+        int shift = 0;
+        for (char c : a) { k |= std::uint64_t(std::uint8_t(c)) << shift; shift += 8; }
+        for (char c : b) { k |= std::uint64_t(std::uint8_t(c)) << shift; shift += 8; }
+        return k;
+    }
+
+    template <IsQuantity Q>
+    constexpr ParseSymbol parse_symbol(std::uint64_t key, double factor = 1.0, double offset = 0.0) {
+        using D = typename Q::DimensionType;
+        return {key, factor, offset, {D::code, D::ext}};
+    }
+
+    struct SymbolTable {
+        static constexpr int kCapacity = 192;
+        static constexpr int kSlotBits = 12;
+
+        ParseSymbol   symbols[kCapacity] = {};
+        int           size       = 0;
+        std::uint64_t multiplier = 0;
+        std::uint8_t  slots[1 << kSlotBits] = {};   // symbol index + 1, 0 when empty
+
+        static constexpr int slot(std::uint64_t key, std::uint64_t m) { return int((key * m) >> (64 - kSlotBits)); }
+
+        constexpr void add(ParseSymbol s) {
+            if (size == kCapacity) throw "parse_quantity: symbol table full";
+            for (int i = 0; i < size; ++i)
+                if (symbols[i].key == s.key) throw "parse_quantity: duplicate symbol";
+            symbols[size++] = s;
+        }
+
+        // Search odd multipliers until every key has a slot of its own
+        constexpr void build() {
+            std::uint64_t state = 0x9e3779b97f4a7c15;
+            for (int attempt = 0; attempt < 10000; ++attempt) {
+                std::uint64_t m = (state += 0x9e3779b97f4a7c15);   // splitmix64
+                m = (m ^ (m >> 30)) * 0xbf58476d1ce4e5b9;
+                m = (m ^ (m >> 27)) * 0x94d049bb133111eb;
+                m = (m ^ (m >> 31)) | 1;
+                for (auto& s : slots) s = 0;
+                bool ok = true;
+                for (int i = 0; i < size && ok; ++i) {
+                    std::uint8_t& s = slots[slot(symbols[i].key, m)];
+                    ok = s == 0;
+                    s  = std::uint8_t(i + 1);
+                }
+                if (ok) {
+                    multiplier = m;
+                    return;
+                }
+            }
+            throw "parse_quantity: no perfect hash found";
+        }
+
+        constexpr const ParseSymbol* find(std::uint64_t key) const {
+            const int i = slots[slot(key, multiplier)];
+            return i != 0 && symbols[i - 1].key == key ? &symbols[i - 1] : nullptr;
+        }
+    };
+
+    constexpr SymbolTable make_symbol_table() {
+#define DAL_PARSE_NAME(name) std::string_view(#name),
+#define DAL_PARSE_SYMBOL(name) parse_symbol<unit::name::quantity>(symbol_key(#name), unit::name::factor),
+        constexpr std::string_view names[]  = {DAL_FOR_EACH_LINEAR_UNIT(DAL_PARSE_NAME)};
+        constexpr ParseSymbol      linear[] = {DAL_FOR_EACH_LINEAR_UNIT(DAL_PARSE_SYMBOL)};
+#undef DAL_PARSE_SYMBOL
+#undef DAL_PARSE_NAME
+
+        SymbolTable t;
+        for (std::size_t i = 0; i < std::size(linear); ++i) {
+            const std::string_view n = names[i];
+            ParseSymbol s = linear[i];
+            t.add(s);
+            if (n.size() > 1 && n[0] == 'u') {                      // µs, μs
+                s.key = symbol_key("\xc2\xb5", n.substr(1));
+                t.add(s);
+                s.key = symbol_key("\xce\xbc", n.substr(1));
+                t.add(s);
+            }
+            if (n.ends_with("ohm")) {                               // kΩ
+                s.key = symbol_key(n.substr(0, n.size() - 3), "\xce\xa9");
+                t.add(s);
+            }
+        }
+        t.add(parse_symbol<unit::degC::quantity>(symbol_key("degC"), unit::degC::factor, unit::degC::offset));
+        t.add(parse_symbol<unit::degC::quantity>(symbol_key("\xc2\xb0" "C"), unit::degC::factor, unit::degC::offset));
+        t.add(parse_symbol<unit::degF::quantity>(symbol_key("degF"), unit::degF::factor, unit::degF::offset));
+        t.add(parse_symbol<unit::degF::quantity>(symbol_key("\xc2\xb0" "F"), unit::degF::factor, unit::degF::offset));
+        t.add(parse_symbol<CatalyticActivity>(symbol_key("kat")));
+        t.add(parse_symbol<Count>(symbol_key("count")));
+        t.build();
+        return t;
+    }
+
+    inline constexpr SymbolTable kParseSymbols = make_symbol_table();
+
+    // Product of the terms read so far: SI factor and dimension
+    struct UnitTerm {
+        DimCodes dims{0, 0};
+        double   factor = 1.0;
+    };
+
+    struct UnitState {
+        int    terms         = 0;
+        bool   affine        = false;
+        bool   unknown_first = false;   // the unit's first symbol is not in the table
+        double offset        = 0.0;
+    };
+
+    inline constexpr int kMaxUnitDepth = 8;
+
+    constexpr bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+    constexpr bool is_middle_dot(const char* p, const char* last) {
+        return last - p >= 2 && p[0] == '\xc2' && p[1] == '\xb7';
+    }
+
+    // ASCII letters and any non-ASCII byte except the separator '·'
+    constexpr bool is_symbol_byte(const char* p, const char* last) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') return true;
+        return c >= 0x80 && !is_middle_dot(p, last);
+    }
+
+    // End of the symbol at p, with its first eight bytes packed into key
+    constexpr const char* scan_symbol(const char* p, const char* last, std::uint64_t& key) {
+        const char* s = p;
+        key = 0;
+        for (; p != last && is_symbol_byte(p, last); ++p)
+            if (p - s < 8) key |= std::uint64_t(static_cast<unsigned char>(*p)) << (8 * (p - s));
+        return p;
+    }
+
+    // Whether the text at p starts with a symbol of the table: after spaces,
+    // anything else ends the unit rather than being an error
+    constexpr bool at_known_symbol(const char* p, const char* last) {
+        std::uint64_t key;
+        const char* end = scan_symbol(p, last, key);
+        return end != p && end - p <= 8 && kParseSymbols.find(key);
+    }
+
+    constexpr const char* skip_spaces(const char* p, const char* last) {
+        while (p != last && *p == ' ') ++p;
+        return p;
+    }
+
+    // Optional sign and one to three digits
+    constexpr bool parse_small_int(const char*& p, const char* last, int& out) {
+        bool negative = false;
+        if (p != last && (*p == '-' || *p == '+')) negative = *p++ == '-';
+        if (p == last || !is_digit(*p)) return false;
+        int v = 0;
+        for (int n = 0; p != last && is_digit(*p); ++n) {
+            if (n == 3) return false;
+            v = v * 10 + (*p++ - '0');
+        }
+        out = negative ? -v : v;
+        return true;
+    }
+
+    // "^n" or "^(p/q)"; without a '^' the exponent is 1
+    constexpr bool parse_exponent(const char*& p, const char* last, int& num, int& den) {
+        num = den = 1;
+        if (p == last || *p != '^') return true;
+        ++p;
+        if (p == last || *p != '(') return parse_small_int(p, last, num);
+        ++p;
+        if (!parse_small_int(p, last, num)) return false;
+        if (p != last && *p == '/') {
+            ++p;
+            if (!parse_small_int(p, last, den) || den <= 0 || den > 256) return false;
+        }
+        if (p == last || *p != ')') return false;
+        ++p;
+        return true;
+    }
+
+    inline double pow_int(double f, int n) {
+        double r = 1.0;
+        for (unsigned k = n < 0 ? -unsigned(n) : unsigned(n); k; k >>= 1, f *= f)
+            if (k & 1) r *= f;
+        return n < 0 ? 1.0 / r : r;
+    }
+
+    // acc · t^(num/den); false if the dimension leaves the encodable range.
+    // Exponents ±1 and ±2 — nearly every term — are one or two SWAR steps.
+    inline bool apply_term(UnitTerm& acc, const UnitTerm& t, int num, int den) {
+        if (den == 1 && num >= -2 && num <= 2) {
+            for (int k = num < 0 ? -num : num; k; --k)
+                if (!try_combine_codes(acc.dims, t.dims, num < 0 ? -1 : 1, acc.dims)) return false;
+        } else {
+            const Exponents x = combine(decode(acc.dims.si, acc.dims.ext), scale(decode(t.dims.si, t.dims.ext), num, den), 1);
+            if (!encodable(x)) return false;
+            acc.dims = encode(x);
+        }
+        if (t.factor != 1.0) acc.factor *= den == 1 ? pow_int(t.factor, num) : std::pow(t.factor, double(num) / den);
+        return true;
+    }
+
+    inline std::errc parse_unit(const char*& p, const char* last, UnitTerm& acc, UnitState& st, int depth);
+
+    // One term, multiplied into acc with the given sign
+    inline std::errc parse_term(const char*& p, const char* last, UnitTerm& acc, UnitState& st,
+                                int sign, int depth, bool first) {
+        UnitTerm t;
+        double offset = 0.0;
+        if (p == last) return std::errc::invalid_argument;
+        if (*p == '(') {
+            if (depth == kMaxUnitDepth) return std::errc::invalid_argument;
+            p = skip_spaces(p + 1, last);
+            if (const std::errc ec = parse_unit(p, last, t, st, depth + 1); ec != std::errc()) return ec;
+            p = skip_spaces(p, last);
+            if (p == last || *p != ')') return std::errc::invalid_argument;
+            ++p;
+        } else if (first && *p == '1' && (p + 1 == last || !is_digit(p[1]))) {
+            ++p;                                                    // dimensionless
+        } else {
+            std::uint64_t key;
+            const char* s = p;
+            p = scan_symbol(p, last, key);
+            const ParseSymbol* sym = p - s <= 8 ? kParseSymbols.find(key) : nullptr;
+            if (!sym) {
+                st.unknown_first = depth == 0 && st.terms == 0;
+                return std::errc::invalid_argument;
+            }
+            t.dims   = sym->dims;
+            t.factor = sym->factor;
+            offset   = sym->offset;
+        }
+        int num, den;
+        if (!parse_exponent(p, last, num, den)) return std::errc::invalid_argument;
+        if (offset != 0.0) {
+            // °C and °F only mean something on their own
+            if (depth != 0 || sign < 0 || num != 1 || den != 1 || st.terms != 0) return std::errc::invalid_argument;
+            st.affine = true;
+            st.offset = offset;
+        } else if (st.affine) {
+            return std::errc::invalid_argument;
+        }
+        ++st.terms;
+        return apply_term(acc, t, sign * num, den) ? std::errc() : std::errc::result_out_of_range;
+    }
+
+    inline std::errc parse_unit(const char*& p, const char* last, UnitTerm& acc, UnitState& st, int depth) {
+        if (const std::errc ec = parse_term(p, last, acc, st, 1, depth, true); ec != std::errc()) return ec;
+        for (;;) {
+            const char* end = p;
+            p = skip_spaces(p, last);
+            int sign = 1;
+            if (p != last && (*p == '*' || *p == '/')) {
+                sign = *p++ == '/' ? -1 : 1;
+            } else if (is_middle_dot(p, last)) {
+                p += 2;
+            } else if (p != end && at_known_symbol(p, last)) {
+                // "N m": spaces between terms multiply
+            } else {
+                p = end;
+                return std::errc();
+            }
+            p = skip_spaces(p, last);
+            if (const std::errc ec = parse_term(p, last, acc, st, sign, depth, false); ec != std::errc()) return ec;
+        }
+    }
+}
+
+// Read "number [unit]" from [first, last). On success ptr is one past the last
+// character of the quantity; the unit is optional, and a number on its own is
+// dimensionless. Errors, with out unchanged:
+//   std::errc::invalid_argument   — no number, unknown symbol or bad syntax (ptr == first)
+//   std::errc::result_out_of_range — number or exponents out of range
+inline std::from_chars_result parse_quantity(const char* first, const char* last, DynQuantity& out) {
+    double v;
+    const std::from_chars_result number = std::from_chars(first, last, v);
+    if (number.ec != std::errc()) return number;
+
+    detail::UnitTerm  acc;
+    detail::UnitState st;
+    const char* p = number.ptr;
+    const char* q = detail::skip_spaces(p, last);
+    std::errc ec{};
+    if (q != last && *q == '[') {
+        q  = detail::skip_spaces(q + 1, last);
+        ec = detail::parse_unit(q, last, acc, st, 0);
+        q  = detail::skip_spaces(q, last);
+        if (ec == std::errc() && (q == last || *q != ']')) ec = std::errc::invalid_argument;
+        if (ec == std::errc()) p = q + 1;
+    } else if (q != last && detail::is_symbol_byte(q, last)) {
+        // A unit right after the number must parse; after spaces it must
+        // start with a known symbol, so "3 apples" is a dimensionless 3
+        const bool spaced = q != p;
+        ec = detail::parse_unit(q, last, acc, st, 0);
+        if (ec == std::errc::invalid_argument && spaced && st.unknown_first) {
+            acc = {};
+            st  = {};
+            ec  = std::errc();
+        } else {
+            p = q;
+        }
+    }
+    if (ec == std::errc::invalid_argument) return {first, ec};
+    if (ec != std::errc()) return {p, ec};
+
+    out.value = v * acc.factor + st.offset;
+    out.dims  = acc.dims;
+    return {p, std::errc()};
+}
+
+// As above, and the dimension must be Q's; a different one is
+// std::errc::argument_out_of_domain, with ptr past the quantity
+template <IsQuantity Q>
+    requires std::is_floating_point_v<typename Q::RepType>
+std::from_chars_result parse_quantity(const char* first, const char* last, Q& out) {
+    DynQuantity parsed;
+    const std::from_chars_result r = parse_quantity(first, last, parsed);
+    if (r.ec != std::errc()) return r;
+    if (!parsed.is<Q>()) return {r.ptr, std::errc::argument_out_of_domain};
+    out = Q(static_cast<typename Q::RepType>(parsed.value));
+    return r;
+}
+
+namespace detail {
+    // The whole of text, apart from trailing spaces, must be one quantity
+    template <typename T>
+    T parse_whole_quantity(std::string_view text) {
+        T out = [] {
+            if constexpr (IsQuantity<T>) return T(0.0);
+            else                         return T{};
+        }();
+        const char* last = text.data() + text.size();
+        std::from_chars_result r = parse_quantity(text.data(), last, out);
+        if (r.ec == std::errc() && skip_spaces(r.ptr, last) != last) r.ec = std::errc::invalid_argument;
+        if (r.ec == std::errc()) return out;
+        const std::string quoted = "parse_quantity: \"" + std::string(text) + "\"";
+        if (r.ec == std::errc::argument_out_of_domain) throw std::invalid_argument(quoted + " has the wrong dimension");
+        if (r.ec == std::errc::result_out_of_range)    throw std::out_of_range(quoted + " is out of range");
+        throw std::invalid_argument(quoted + " is not a quantity");
+    }
+}
+
+// Throwing forms for whole strings: std::invalid_argument for text that is
+// not one quantity or has the wrong dimension, std::out_of_range for values
+// or exponents out of range
+inline DynQuantity parse_quantity(std::string_view text) { return detail::parse_whole_quantity<DynQuantity>(text); }
+
+template <IsQuantity Q>
+    requires std::is_floating_point_v<typename Q::RepType>
+Q parse_quantity(std::string_view text) { return detail::parse_whole_quantity<Q>(text); }
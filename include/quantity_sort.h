@@ -0,0 +1,258 @@
+#pragma once
+#include "quantity_vector.h"
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <latch>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// LSD radix sort of quantity columns, optionally carrying a payload.
+//
+//     radix_sort(times);                       // std::vector<Time>, QuantityVector, span, ...
+//     radix_sort(energies, entity_ids);        // ids follow their energies
+//     radix_sort(times, {.threads = 0});       // one thread per hardware thread
+//
+// Each value is mapped to an unsigned key whose order is the value's order:
+// positive numbers get the sign bit set, negative ones are inverted. The sort
+// then makes one counting pass per key byte, eight for double and four for
+// float, skipping any byte that is the same for every element. All byte
+// histograms come from a single read before the first pass.
+//
+// The result agrees with operator<=>, and the sort is stable. -0 and +0
+// compare equal there, so they share a key and keep their order. NaN is
+// unordered, so NaN elements go last, in their original order. Values are
+// moved, never rewritten: the sign of a zero and NaN payloads survive.
+//
+// With threads > 1, each pass splits the column into one contiguous chunk
+// per thread. Each thread counts its chunk's bytes. After a barrier, each
+// thread scatters its chunk to offsets it computes from all the counts. The
+// result is identical to the single-threaded sort.
+
+struct SortOptions {
+    unsigned    threads = 1;                // 0: one per hardware thread
+    std::size_t grain   = 1 << 16;          // fewest elements worth a thread
+};
+
+namespace detail {
+    template <typename T>
+    using sort_key_t = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+
+    template <typename T>
+    sort_key_t<T> sort_key(T x) {
+        using K = sort_key_t<T>;
+        constexpr K sign = K(1) << (8 * sizeof(K) - 1);
+        // No branches: signs come from the data, and a mispredicted branch per
+        // element per pass costs more than the pass. flip is all ones for a
+        // negative value, the sign bit otherwise.
+        const K u    = std::bit_cast<K>(x);
+        const K flip = (K(0) - (u >> (8 * sizeof(K) - 1))) | sign;
+        K key = u ^ flip;
+        key = u == sign ? sign : key;         // -0: with +0
+        return x != x ? ~K(0) : key;          // NaN: after +infinity
+    }
+
+    // Payload slot for a keys-only sort
+    struct NoPayload {};
+
+    template <typename Q, typename V>
+    struct SortColumns {
+        Q* keys;
+        V* values;
+
+        void put(std::size_t to, const SortColumns& from, std::size_t i) const {
+            keys[to] = from.keys[i];
+            if constexpr (!std::is_same_v<V, NoPayload>) values[to] = from.values[i];
+        }
+        void copy_to(const SortColumns& out, std::size_t first, std::size_t last) const {
+            if (first == last) return;
+            std::memcpy(static_cast<void*>(out.keys + first), keys + first, (last - first) * sizeof(Q));
+            if constexpr (!std::is_same_v<V, NoPayload>)
+                std::memcpy(static_cast<void*>(out.values + first), values + first, (last - first) * sizeof(V));
+        }
+    };
+
+    inline constexpr int kRadixBuckets = 256;
+    using RadixCounts = std::array<std::size_t, kRadixBuckets>;
+    template <int D>
+    using DigitCounts = std::array<RadixCounts, D>;
+
+    template <typename Q>
+    unsigned radix_digit(const Q& q, int d) {
+        return unsigned(sort_key(q.value) >> (8 * d)) & (kRadixBuckets - 1);
+    }
+
+    // Counts of every key byte of keys[first, last)
+    template <int D, typename Q>
+    void count_all_digits(const Q* keys, std::size_t first, std::size_t last, DigitCounts<D>& counts) {
+        for (auto& c : counts) c.fill(0);
+        for (std::size_t i = first; i < last; ++i) {
+            const auto key = sort_key(keys[i].value);
+            for (int d = 0; d < D; ++d) ++counts[d][unsigned(key >> (8 * d)) & (kRadixBuckets - 1)];
+        }
+    }
+
+    // A byte that every key shares needs no pass
+    inline bool single_bucket(const RadixCounts& total, std::size_t n) {
+        return std::find(total.begin(), total.end(), n) != total.end();
+    }
+
+    // Scratch columns of n elements, allocated without initialising them
+    template <typename Q, typename V>
+    struct SortScratch {
+        std::unique_ptr<typename Q::RepType[]> keys;
+        std::unique_ptr<V[]>                   values;
+        explicit SortScratch(std::size_t n) : keys(std::make_unique_for_overwrite<typename Q::RepType[]>(n)) {
+            if constexpr (!std::is_same_v<V, NoPayload>) values = std::make_unique_for_overwrite<V[]>(n);
+        }
+        SortColumns<Q, V> columns() { return {reinterpret_cast<Q*>(keys.get()), values.get()}; }
+    };
+
+    template <typename Q, typename V>
+    void radix_sort_serial(SortColumns<Q, V> data, std::size_t n) {
+        constexpr int D = int(sizeof(typename Q::RepType));
+        DigitCounts<D> counts;
+        count_all_digits<D>(data.keys, 0, n, counts);
+        SortScratch<Q, V> scratch(n);
+        SortColumns<Q, V> src = data, dst = scratch.columns();
+        for (int d = 0; d < D; ++d) {
+            if (single_bucket(counts[d], n)) continue;
+            std::size_t offset[kRadixBuckets];
+            std::size_t sum = 0;
+            for (int b = 0; b < kRadixBuckets; ++b) {
+                offset[b] = sum;
+                sum += counts[d][b];
+            }
+            for (std::size_t i = 0; i < n; ++i) dst.put(offset[radix_digit(src.keys[i], d)]++, src, i);
+            std::swap(src, dst);
+        }
+        if (src.keys != data.keys) src.copy_to(data, 0, n);
+    }
+
+    template <typename Q, typename V>
+    void radix_sort_parallel(SortColumns<Q, V> data, std::size_t n, std::size_t wanted) {
+        constexpr int D = int(sizeof(typename Q::RepType));
+        SortScratch<Q, V> scratch(n);
+        const SortColumns<Q, V> other = scratch.columns();
+
+        // Workers wait at the gate until every thread that could be started has
+        // been, so a failed launch only shrinks the team. Everything that can
+        // throw happens before the first launch; afterwards the counts shrink
+        // and the barrier drops the missing participants
+        std::size_t threads = wanted;
+        std::vector<DigitCounts<D>> initial(wanted);   // per thread, every byte, first chunk
+        std::vector<RadixCounts> chunk(wanted);        // per thread, current byte
+        std::barrier<> sync{std::ptrdiff_t(wanted)};
+        std::latch gate(1);
+        auto bound = [&](std::size_t t) { return n / threads * t + std::min(t, n % threads); };
+
+        auto work = [&](std::size_t t) {
+            const std::size_t first = bound(t), last = bound(t + 1);
+            count_all_digits<D>(data.keys, first, last, initial[t]);
+            sync.arrive_and_wait();
+
+            // Every thread derives the same totals, and so the same passes
+            DigitCounts<D> total{};
+            for (const auto& c : initial)
+                for (int d = 0; d < D; ++d)
+                    for (int b = 0; b < kRadixBuckets; ++b) total[d][b] += c[d][b];
+
+            SortColumns<Q, V> src = data, dst = other;
+            for (int d = 0; d < D; ++d) {
+                if (single_bucket(total[d], n)) continue;
+                RadixCounts& own = chunk[t];
+                own.fill(0);
+                for (std::size_t i = first; i < last; ++i) ++own[radix_digit(src.keys[i], d)];
+                sync.arrive_and_wait();
+
+                // Bucket b of this chunk follows all smaller buckets and bucket
+                // b of the chunks before it, which keeps the sort stable
+                std::size_t offset[kRadixBuckets];
+                std::size_t sum = 0;
+                for (int b = 0; b < kRadixBuckets; ++b) {
+                    offset[b] = sum;
+                    for (std::size_t u = 0; u < t; ++u) offset[b] += chunk[u][b];
+                    sum += total[d][b];
+                }
+                for (std::size_t i = first; i < last; ++i) dst.put(offset[radix_digit(src.keys[i], d)]++, src, i);
+                sync.arrive_and_wait();
+                std::swap(src, dst);
+            }
+            if (src.keys != data.keys) src.copy_to(data, first, last);
+        };
+
+        std::vector<std::jthread> workers;
+        workers.reserve(wanted - 1);
+        try {
+            for (std::size_t t = 1; t < wanted; ++t)
+                workers.emplace_back([&, t] {
+                    gate.wait();
+                    work(t);
+                });
+        } catch (...) {
+            // Out of threads (system_error) or thread state (bad_alloc): sort
+            // with the ones already running, which are waiting at the gate
+        }
+        threads = workers.size() + 1;
+        initial.resize(threads);
+        chunk.resize(threads);
+        for (std::size_t t = threads; t < wanted; ++t) sync.arrive_and_drop();
+        gate.count_down();
+        work(0);
+    }
+
+    template <typename Q, typename V>
+    void radix_sort_columns(SortColumns<Q, V> data, std::size_t n, const SortOptions& opts) {
+        if (n < 2) return;
+        std::size_t t = opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+        t = std::min(t, std::max<std::size_t>(1, n / std::max<std::size_t>(opts.grain, 1)));
+        if (t == 1) radix_sort_serial(data, n);
+        else        radix_sort_parallel(data, n, t);
+    }
+
+    template <typename R>
+    using mutable_span_of_t = decltype(std::span(std::declval<R&>()));
+}
+
+// A writable contiguous range of quantities with a float or double Rep
+template <typename R>
+concept RadixSortable = requires(R& r) { std::span(r); } &&
+                        IsQuantity<typename detail::mutable_span_of_t<R>::element_type> &&
+                        (std::is_same_v<typename detail::mutable_span_of_t<R>::element_type::RepType, double> ||
+                         std::is_same_v<typename detail::mutable_span_of_t<R>::element_type::RepType, float>);
+
+// Sort ascending, in the order of operator<=> (see above)
+template <typename R>
+    requires RadixSortable<std::remove_reference_t<R>>
+void radix_sort(R&& keys, const SortOptions& opts = {}) {
+    const auto k = std::span(keys);
+    using Q = typename decltype(k)::element_type;
+    static_assert(detail::rep_layout_v<Q>, "radix_sort: Quantity must be layout-compatible with Rep");
+    detail::radix_sort_columns(detail::SortColumns<Q, detail::NoPayload>{k.data(), nullptr}, k.size(), opts);
+}
+
+// Sort keys and apply the same permutation to values, a writable contiguous
+// range of trivially copyable, default-constructible elements (entity ids,
+// row numbers, small records). Sizes that differ throw std::invalid_argument.
+template <typename R, typename V>
+    requires RadixSortable<std::remove_reference_t<R>> && requires(V& v) { std::span(v); }
+void radix_sort(R&& keys, V&& values, const SortOptions& opts = {}) {
+    const auto k = std::span(keys);
+    const auto v = std::span(values);
+    using Q = typename decltype(k)::element_type;
+    using P = typename decltype(v)::element_type;
+    static_assert(detail::rep_layout_v<Q>, "radix_sort: Quantity must be layout-compatible with Rep");
+    static_assert(!std::is_const_v<P> && std::is_trivially_copyable_v<P> && std::is_default_constructible_v<P>,
+                  "radix_sort: values must be writable, trivially copyable and default-constructible");
+    if (k.size() != v.size()) throw std::invalid_argument("radix_sort: keys and values differ in size");
+    detail::radix_sort_columns(detail::SortColumns<Q, P>{k.data(), v.data()}, k.size(), opts);
+}
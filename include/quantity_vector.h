@@ -0,0 +1,390 @@
+#pragma once
+#include "quantity_pack.h"
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// QuantityVector<Dim, Rep> — a contiguous, 64-byte aligned column of
+// Quantity<Dim, Rep> with element-wise operators.
+//
+// `a * b`, `a / b`, `a + b`, `a - b`, scalar operations, pow<N>, sqrt and abs
+// on vectors do not compute anything: they return a QuantityExpr node that
+// records the operation and carries the result's dimension and Rep, exactly
+// as the scalar operator would compute them. Nodes nest, so a whole formula
+// such as `0.5 * m * pow<2>(v)` becomes one expression tree. Assigning it to a
+// QuantityVector (or calling eval) runs the tree in a single pass over its
+// inputs, without a temporary per operator. When every leaf shares an
+// arithmetic Rep the pass works on QuantityPack<Dim, N, Rep> at the native
+// vector width with a scalar tail; otherwise it is a plain element loop. Both
+// paths evaluate the very same operators, because a QuantityPack is itself a
+// Quantity.
+//
+// Expressions hold vector operands that were lvalues by reference, and take
+// ownership of rvalue vectors. A named expression (`auto e = x * y;`) must not
+// outlive the named vectors it refers to.
+
+namespace detail {
+    inline constexpr std::size_t kVectorAlign = 64;
+
+    // T holds nothing but bits that need no initialisation: trivially default
+    // constructible itself, or a Quantity whose Rep is
+    template <typename T>
+    inline constexpr bool trivial_storage_v = std::is_trivially_default_constructible_v<T>;
+    template <typename T>
+        requires IsQuantity<T>
+    inline constexpr bool trivial_storage_v<T> =
+        rep_layout_v<T> && std::is_trivially_default_constructible_v<typename T::RepType>;
+
+    template <typename T>
+    struct AlignedAllocator {
+        using value_type = T;
+        AlignedAllocator() = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U>&) {}
+        T* allocate(std::size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{kVectorAlign}));
+        }
+        void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t{kVectorAlign}); }
+        // Value-initialisation leaves elements uninitialised when their storage
+        // is trivial: kernel outputs are overwritten in full, so zero-filling
+        // them first is a wasted pass. Other element types are still
+        // initialised: a Quantity with a Rep such as FixedPoint gets Rep{}.
+        template <typename U>
+        void construct(U* p) noexcept(trivial_storage_v<U> || std::is_nothrow_default_constructible_v<U>) {
+            if constexpr (trivial_storage_v<U>)                    {}
+            else if constexpr (std::is_default_constructible_v<U>) ::new (static_cast<void*>(p)) U();
+            else                                                   ::new (static_cast<void*>(p)) U(typename U::RepType{});
+        }
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+        template <typename U>
+        bool operator==(const AlignedAllocator<U>&) const { return true; }
+    };
+}
+
+template <typename F, typename... Args>
+class QuantityExpr;
+
+template <typename T>
+inline constexpr bool is_quantity_expr_v = false;
+template <typename F, typename... Args>
+inline constexpr bool is_quantity_expr_v<QuantityExpr<F, Args...>> = true;
+
+template <typename Dim, typename Rep = double>
+class QuantityVector {
+public:
+    using value_type     = Quantity<Dim, Rep>;
+    using DimensionType  = Dim;
+    using RepType        = Rep;
+    using iterator       = value_type*;
+    using const_iterator = const value_type*;
+
+private:
+    static_assert(detail::rep_layout_v<value_type>, "QuantityVector: Quantity must be layout-compatible with Rep");
+    std::vector<value_type, detail::AlignedAllocator<value_type>> items;
+
+    template <typename E>
+    void assign_expr(const E& e);
+
+public:
+    QuantityVector() = default;
+    explicit QuantityVector(std::size_t n, value_type fill = value_type(Rep(0))) : items(n, fill) {}
+    QuantityVector(std::initializer_list<value_type> init) : items(init) {}
+    template <typename It>
+    QuantityVector(It first, It last) : items(first, last) {}
+
+    // n elements with unspecified values, for callers that overwrite them all
+    struct uninitialized_t {};
+    QuantityVector(uninitialized_t, std::size_t n) { items.resize(n); }
+
+    // Evaluate an expression in one pass. Implicit when the element types
+    // match; a change of Rep must be spelled out, as for Quantity itself.
+    template <typename E>
+        requires is_quantity_expr_v<E> && std::is_same_v<typename E::value_type, value_type>
+    QuantityVector(const E& e) { assign_expr(e); }
+    template <typename E>
+        requires is_quantity_expr_v<E> && std::is_same_v<typename E::DimensionType, Dim> &&
+                 (!std::is_same_v<typename E::value_type, value_type>)
+    explicit QuantityVector(const E& e) { assign_expr(e); }
+
+    // Element-wise expressions may read this vector: element i of the result
+    // depends only on element i of each operand, so evaluation in place is safe
+    template <typename E>
+        requires is_quantity_expr_v<E> && std::is_same_v<typename E::value_type, value_type>
+    QuantityVector& operator=(const E& e) {
+        assign_expr(e);
+        return *this;
+    }
+
+    std::size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+
+    value_type*       data()       { return items.data(); }
+    const value_type* data() const { return items.data(); }
+    value_type&       operator[](std::size_t i)       { return items[i]; }
+    const value_type& operator[](std::size_t i) const { return items[i]; }
+
+    iterator       begin()       { return items.data(); }
+    iterator       end()         { return items.data() + items.size(); }
+    const_iterator begin() const { return items.data(); }
+    const_iterator end()   const { return items.data() + items.size(); }
+
+    std::span<value_type>       span()       { return items; }
+    std::span<const value_type> span() const { return items; }
+
+    void push_back(value_type q) { items.push_back(q); }
+    void resize(std::size_t n, value_type fill = value_type(Rep(0))) { items.resize(n, fill); }
+    void reserve(std::size_t n) { items.reserve(n); }
+    void clear() { items.clear(); }
+};
+
+// Raw storage viewed as quantities and back, without copying: a column read
+// from a file or a mapped buffer becomes a span of Quantity<Dim, Rep> in
+// place. The values must already be in SI units (see convert<U> otherwise).
+// Rep is the span's element type; constness and a static extent carry over.
+template <typename Dim, typename T, std::size_t Extent>
+auto as_quantities(std::span<T, Extent> raw) {
+    using Rep = std::remove_const_t<T>;
+    using Q   = std::conditional_t<std::is_const_v<T>, const Quantity<Dim, Rep>, Quantity<Dim, Rep>>;
+    static_assert(detail::rep_layout_v<Quantity<Dim, Rep>>, "as_quantities: Quantity must be layout-compatible with Rep");
+    return std::span<Q, Extent>(reinterpret_cast<Q*>(raw.data()), raw.size());
+}
+
+// The values of a span of quantities as their Rep — double unless stated
+template <typename Q, std::size_t Extent>
+    requires IsQuantity<std::remove_const_t<Q>>
+auto as_doubles(std::span<Q, Extent> q) {
+    using Rep = typename std::remove_const_t<Q>::RepType;
+    using T   = std::conditional_t<std::is_const_v<Q>, const Rep, Rep>;
+    static_assert(detail::rep_layout_v<std::remove_const_t<Q>>, "as_doubles: Quantity must be layout-compatible with Rep");
+    return std::span<T, Extent>(reinterpret_cast<T*>(q.data()), q.size());
+}
+
+template <typename T>
+inline constexpr bool is_quantity_vector_v = false;
+template <typename Dim, typename Rep>
+inline constexpr bool is_quantity_vector_v<QuantityVector<Dim, Rep>> = true;
+
+// `QuantityVector v = x / t;` deduces Velocity's dimension and Rep
+template <typename E>
+    requires is_quantity_expr_v<E>
+QuantityVector(const E&) -> QuantityVector<typename E::DimensionType, typename E::RepType>;
+
+namespace detail {
+    // Operand adapters: a vector or expression yields its i-th element (or an
+    // N-lane pack starting there); a scalar Quantity or plain number yields
+    // itself and is broadcast by the operators.
+    template <typename T>
+    decltype(auto) element(const T& x, std::size_t i) {
+        if constexpr (is_quantity_vector_v<T> || is_quantity_expr_v<T>) return x[i];
+        else                                                             return (x);
+    }
+    template <int N, typename T>
+    decltype(auto) element_pack(const T& x, std::size_t i) {
+        if constexpr (is_quantity_vector_v<T>)    return load_pack<N>(x.data() + i);
+        else if constexpr (is_quantity_expr_v<T>) return x.template pack<N>(i);
+        else                                      return (x);
+    }
+
+    // Common length of the operands; scalars leave `n` unchanged
+    template <typename T>
+    std::size_t operand_size(const T& x, std::size_t n) {
+        if constexpr (is_quantity_vector_v<T> || is_quantity_expr_v<T>) {
+            if (n != std::size_t(-1) && x.size() != n)
+                throw std::invalid_argument("QuantityVector: operand sizes differ");
+            return x.size();
+        } else {
+            return n;
+        }
+    }
+
+    // Element operations run on packs unless they declare lane_wise = false
+    template <typename F>
+    inline constexpr bool lane_wise_v = true;
+    template <typename F>
+        requires requires { F::lane_wise; }
+    inline constexpr bool lane_wise_v<F> = F::lane_wise;
+
+    // True when every leaf of the operand can join a pack of Rep lanes: plain
+    // numbers (converted and broadcast) and quantities / vectors of that Rep
+    template <typename T, typename Rep>
+    struct packs_with : std::is_arithmetic<T> {};
+    template <typename Dim, typename R, typename Rep>
+    struct packs_with<Quantity<Dim, R>, Rep> : std::is_same<R, Rep> {};
+    template <typename Dim, typename R, typename Rep>
+    struct packs_with<QuantityVector<Dim, R>, Rep> : std::is_same<R, Rep> {};
+    template <typename F, typename... Args, typename Rep>
+    struct packs_with<QuantityExpr<F, Args...>, Rep>
+        : std::bool_constant<lane_wise_v<F> && (packs_with<std::remove_cvref_t<Args>, Rep>::value && ...)> {};
+
+    // How an expression node stores an operand: named vectors by reference,
+    // temporary vectors by value (moved in), everything else by value
+    template <typename T>
+    using operand_t = std::conditional_t<is_quantity_vector_v<std::remove_cvref_t<T>> && std::is_lvalue_reference_v<T>,
+                                         const std::remove_cvref_t<T>&, std::remove_cvref_t<T>>;
+
+    template <typename T>
+    concept VectorOperand = is_quantity_vector_v<T> || is_quantity_expr_v<T> || IsQuantity<T> || std::is_arithmetic_v<T>;
+
+    // At least one side of a binary operator must be a vector or an expression
+    template <typename A, typename B>
+    concept VectorBinary = VectorOperand<A> && VectorOperand<B> &&
+                           (is_quantity_vector_v<A> || is_quantity_expr_v<A> ||
+                            is_quantity_vector_v<B> || is_quantity_expr_v<B>);
+
+    template <typename T>
+    concept VectorUnary = is_quantity_vector_v<T> || is_quantity_expr_v<T>;
+
+    // Element operations, written once for scalar quantities and packs
+    struct Multiplies { template <typename X, typename Y> auto operator()(const X& x, const Y& y) const { return x * y; } };
+    struct Divides    { template <typename X, typename Y> auto operator()(const X& x, const Y& y) const { return x / y; } };
+    struct Plus       { template <typename X, typename Y> auto operator()(const X& x, const Y& y) const { return x + y; } };
+    struct Minus      { template <typename X, typename Y> auto operator()(const X& x, const Y& y) const { return x - y; } };
+    struct Negate     { template <typename X> auto operator()(const X& x) const { return -x; } };
+    struct Sqrt       { template <typename X> auto operator()(const X& x) const { return sqrt(x); } };
+    struct Abs        { template <typename X> auto operator()(const X& x) const { return abs(x); } };
+    template <int N, int D>
+    struct Pow {
+        // Integer powers and square roots have pack kernels; other roots run per element
+        static constexpr bool lane_wise = (D == 1 || D == 2 || D == -1 || D == -2);
+        template <typename X> auto operator()(const X& x) const { return pow<N, D>(x); }
+    };
+
+    template <typename F, typename... Ts>
+    auto make_expr(Ts&&... xs) {
+        return QuantityExpr<F, operand_t<Ts&&>...>(F{}, std::forward<Ts>(xs)...);
+    }
+}
+
+// One node of an element-wise expression: F applied to Args at every index.
+template <typename F, typename... Args>
+class QuantityExpr {
+    F f;
+    std::tuple<Args...> args;
+    std::size_t n = std::size_t(-1);
+
+public:
+    using value_type    = std::decay_t<decltype(std::declval<const F&>()(
+                              detail::element(std::declval<const std::remove_cvref_t<Args>&>(), 0)...))>;
+    using DimensionType = typename value_type::DimensionType;
+    using RepType       = typename value_type::RepType;
+    static_assert(IsQuantity<value_type>, "QuantityExpr: element operation must produce a Quantity");
+
+    // Operand sizes are checked here, so a mismatch throws where the
+    // offending operator is written rather than at evaluation
+    template <typename... Ts>
+    explicit QuantityExpr(F func, Ts&&... xs) : f(func), args(std::forward<Ts>(xs)...) {
+        std::apply([&](const auto&... a) { ((n = detail::operand_size(a, n)), ...); }, args);
+    }
+
+    std::size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+
+    value_type operator[](std::size_t i) const {
+        return std::apply([&](const auto&... a) { return f(detail::element(a, i)...); }, args);
+    }
+
+    // Lanes i .. i+N-1 as a QuantityPack
+    template <int N>
+    auto pack(std::size_t i) const {
+        return std::apply([&](const auto&... a) { return f(detail::element_pack<N>(a, i)...); }, args);
+    }
+
+    // Whether evaluation can run on packs of RepType
+    static constexpr bool vectorizable =
+        std::is_arithmetic_v<RepType> && detail::packs_with<QuantityExpr, RepType>::value;
+};
+
+template <typename Dim, typename Rep>
+template <typename E>
+void QuantityVector<Dim, Rep>::assign_expr(const E& e) {
+    const std::size_t n = e.size();
+    if (items.size() != n) {
+        items.clear();
+        items.resize(n);
+    }
+    value_type* out = items.data();
+    std::size_t i = 0;
+    if constexpr (E::vectorizable && std::is_same_v<typename E::value_type, value_type>) {
+        constexpr int N = simd::kNativeLanes<Rep>;
+        for (; i + N <= n; i += N) store_pack(e.template pack<N>(i), out + i);
+    }
+    for (; i < n; ++i) out[i] = value_type(e[i]);
+}
+
+// Materialise an expression as a vector of its own dimension and Rep
+template <typename E>
+    requires is_quantity_expr_v<E>
+auto eval(const E& e) {
+    return QuantityVector<typename E::DimensionType, typename E::RepType>(e);
+}
+
+// Element-wise operators. Either side may also be a scalar Quantity or a
+// plain number (broadcast); the result dimension is that of the scalar
+// operator, and mismatched dimensions fail to compile exactly as they do for
+// Quantity. Vectors of different sizes throw std::invalid_argument.
+template <typename A, typename B>
+    requires detail::VectorBinary<std::remove_cvref_t<A>, std::remove_cvref_t<B>> &&
+             requires(const std::remove_cvref_t<A>& a, const std::remove_cvref_t<B>& b) {
+                 detail::element(a, 0) * detail::element(b, 0);
+             }
+auto operator*(A&& a, B&& b) {
+    return detail::make_expr<detail::Multiplies>(std::forward<A>(a), std::forward<B>(b));
+}
+
+template <typename A, typename B>
+    requires detail::VectorBinary<std::remove_cvref_t<A>, std::remove_cvref_t<B>> &&
+             requires(const std::remove_cvref_t<A>& a, const std::remove_cvref_t<B>& b) {
+                 detail::element(a, 0) / detail::element(b, 0);
+             }
+auto operator/(A&& a, B&& b) {
+    return detail::make_expr<detail::Divides>(std::forward<A>(a), std::forward<B>(b));
+}
+
+template <typename A, typename B>
+    requires detail::VectorBinary<std::remove_cvref_t<A>, std::remove_cvref_t<B>> &&
+             requires(const std::remove_cvref_t<A>& a, const std::remove_cvref_t<B>& b) {
+                 detail::element(a, 0) + detail::element(b, 0);
+             }
+auto operator+(A&& a, B&& b) {
+    return detail::make_expr<detail::Plus>(std::forward<A>(a), std::forward<B>(b));
+}
+
+template <typename A, typename B>
+    requires detail::VectorBinary<std::remove_cvref_t<A>, std::remove_cvref_t<B>> &&
+             requires(const std::remove_cvref_t<A>& a, const std::remove_cvref_t<B>& b) {
+                 detail::element(a, 0) - detail::element(b, 0);
+             }
+auto operator-(A&& a, B&& b) {
+    return detail::make_expr<detail::Minus>(std::forward<A>(a), std::forward<B>(b));
+}
+
+template <typename A>
+    requires detail::VectorUnary<std::remove_cvref_t<A>>
+auto operator-(A&& a) {
+    return detail::make_expr<detail::Negate>(std::forward<A>(a));
+}
+
+template <int N, int D = 1, typename A>
+    requires detail::VectorUnary<std::remove_cvref_t<A>>
+auto pow(A&& a) {
+    return detail::make_expr<detail::Pow<N, D>>(std::forward<A>(a));
+}
+
+template <typename A>
+    requires detail::VectorUnary<std::remove_cvref_t<A>>
+auto sqrt(A&& a) {
+    return detail::make_expr<detail::Sqrt>(std::forward<A>(a));
+}
+
+template <typename A>
+    requires detail::VectorUnary<std::remove_cvref_t<A>>
+auto abs(A&& a) {
+    return detail::make_expr<detail::Abs>(std::forward<A>(a));
+}
@@ -0,0 +1,306 @@
+#pragma once
+#include "ecs.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Delta-compressed replication of a ComponentPool<T> to a read-only mirror.
+//
+// DeltaEncoder<T> remembers the dense layout it last sent and, each tick,
+// emits one message describing how the pool changed: the new slot count,
+// then runs of consecutive changed slots. Within a run, each component is
+// split into 64-bit words (a Quantity is one word) and every word is XORed
+// with that slot's previous value and written Gorilla-style — unchanged
+// words cost one bit, small changes to a double cost a few more. apply_delta
+// decodes a message straight into the mirror pool, using its current
+// contents as the previous values.
+//
+// Message layout (little-endian host order, same as the snapshot format):
+//   DeltaHeader, then `payload_bytes` of bit-packed payload.
+
+namespace detail {
+    inline constexpr std::uint32_t kDeltaMagic = 0x44454c54;   // "DELT"
+
+    struct DeltaHeader {
+        std::uint32_t magic;
+        std::uint32_t component_size;
+        std::uint64_t slot_count;
+        std::uint64_t run_count;
+        std::uint64_t payload_bytes;
+    };
+
+    class BitWriter {
+        std::vector<std::byte>& out;
+        std::uint64_t acc  = 0;
+        int           used = 0;   // bits in acc
+    public:
+        explicit BitWriter(std::vector<std::byte>& o) : out(o) {}
+        void put(std::uint64_t value, int bits) {   // bits in [1, 64]
+            if (bits < 64) value &= (std::uint64_t(1) << bits) - 1;
+            const int room = 64 - used;
+            if (bits < room) {
+                acc = (acc << bits) | value;
+                used += bits;
+                return;
+            }
+            const int rest = bits - room;
+            acc = room == 64 ? value >> rest : (acc << room) | (value >> rest);
+            for (int i = 7; i >= 0; --i) out.push_back(static_cast<std::byte>(acc >> (8 * i)));
+            acc  = rest ? value & ((std::uint64_t(1) << rest) - 1) : 0;
+            used = rest;
+        }
+        void flush() {
+            for (; used > 0; used -= 8) {
+                const int shift = used - 8;
+                out.push_back(static_cast<std::byte>(shift >= 0 ? acc >> shift : acc << -shift));
+            }
+            acc = 0;
+            used = 0;
+        }
+    };
+
+    class BitReader {
+        const std::byte* p;
+        const std::byte* end;
+        std::uint64_t    acc  = 0;
+        int              left = 0;   // unread bits in acc (low end)
+        void refill() {
+            while (left <= 56) {
+                if (p == end) {
+                    if (left == 0) throw std::runtime_error("apply_delta: truncated payload");
+                    return;
+                }
+                acc = (acc << 8) | std::to_integer<std::uint64_t>(*p++);
+                left += 8;
+            }
+        }
+    public:
+        BitReader(const std::byte* begin, const std::byte* stop) : p(begin), end(stop) {}
+        std::uint64_t get(int bits) {   // bits in [1, 64]
+            std::uint64_t v = 0;
+            while (bits > 0) {
+                if (left == 0) refill();
+                const int take = bits < left ? bits : left;
+                const std::uint64_t chunk = (acc >> (left - take)) & (take == 64 ? ~0ull : (std::uint64_t(1) << take) - 1);
+                v = take == 64 ? chunk : (v << take) | chunk;
+                left -= take;
+                bits -= take;
+            }
+            return v;
+        }
+        bool bit() { return get(1) != 0; }
+    };
+
+    inline void put_varint(BitWriter& w, std::uint64_t v) {
+        while (v >= 0x80) { w.put((v & 0x7f) | 0x80, 8); v >>= 7; }
+        w.put(v, 8);
+    }
+    inline std::uint64_t get_varint(BitReader& r) {
+        std::uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::uint64_t b = r.get(8);
+            v |= (b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        throw std::runtime_error("apply_delta: malformed varint");
+    }
+
+    // Per-word Gorilla state: the leading/trailing-zero window last used
+    struct XorWindow { int lead = -1; int trail = 0; };
+
+    inline void put_xor(BitWriter& w, std::uint64_t x, XorWindow& win) {
+        if (x == 0) { w.put(0, 1); return; }
+        int lead  = std::countl_zero(x);
+        int trail = std::countr_zero(x);
+        if (lead > 31) lead = 31;
+        if (win.lead >= 0 && lead >= win.lead && trail >= win.trail) {
+            w.put(0b10, 2);
+            w.put(x >> win.trail, 64 - win.lead - win.trail);
+            return;
+        }
+        const int len = 64 - lead - trail;
+        w.put(0b11, 2);
+        w.put(lead, 5);
+        w.put(len - 1, 6);
+        w.put(x >> trail, len);
+        win = {lead, trail};
+    }
+
+    inline std::uint64_t get_xor(BitReader& r, XorWindow& win) {
+        if (!r.bit()) return 0;
+        if (!r.bit()) {
+            if (win.lead < 0) throw std::runtime_error("apply_delta: window reuse before definition");
+            return r.get(64 - win.lead - win.trail) << win.trail;
+        }
+        const int lead  = static_cast<int>(r.get(5));
+        const int len   = static_cast<int>(r.get(6)) + 1;
+        const int trail = 64 - lead - len;
+        if (trail < 0) throw std::runtime_error("apply_delta: malformed xor block");
+        win = {lead, trail};
+        return r.get(len) << trail;
+    }
+
+    template <typename T>
+    inline constexpr size_t kDeltaWords = (sizeof(T) + 7) / 8;
+
+    template <typename T>
+    inline void load_words(const T& comp, std::uint64_t* words) {
+        words[kDeltaWords<T> - 1] = 0;
+        std::memcpy(words, &comp, sizeof(T));
+    }
+}
+
+template <typename T>
+class DeltaEncoder {
+    static_assert(std::is_trivially_copyable_v<T>, "DeltaEncoder: component must be trivially copyable");
+    static constexpr size_t W = detail::kDeltaWords<T>;
+
+    std::vector<int>           prev_entities;
+    std::vector<std::uint64_t> prev_words;   // W words per slot
+
+public:
+    // Append one delta message for `pool` (relative to the previous call, or
+    // to an empty pool on the first) to `out`. Returns the message size.
+    size_t encode(const ComponentPool<T>& pool, std::vector<std::byte>& out) {
+        const auto& ents = pool.entities();
+        const auto& data = pool.components();
+        const size_t n = data.size();
+        const size_t old_n = prev_entities.size();
+
+        const size_t header_at = out.size();
+        out.resize(header_at + sizeof(detail::DeltaHeader));
+        const size_t payload_at = out.size();
+
+        detail::BitWriter w(out);
+        std::vector<detail::XorWindow> windows(W);
+        std::uint64_t cur[W];
+        std::uint64_t runs = 0;
+        size_t last_end = 0;
+
+        prev_entities.resize(n, -1);
+        prev_words.resize(n * W, 0);
+
+        auto changed = [&](size_t i) {
+            detail::load_words(data[i], cur);
+            return i >= old_n || ents[i] != prev_entities[i] ||
+                   std::memcmp(cur, &prev_words[i * W], sizeof cur) != 0;
+        };
+
+        for (size_t i = 0; i < n;) {
+            if (!changed(i)) { ++i; continue; }
+            size_t j = i + 1;
+            while (j < n && changed(j)) ++j;
+
+            detail::put_varint(w, i - last_end);   // gap since the previous run
+            detail::put_varint(w, j - i);
+            for (size_t k = i; k < j; ++k) {
+                if (ents[k] == prev_entities[k]) {
+                    w.put(0, 1);
+                } else {
+                    w.put(1, 1);
+                    w.put(static_cast<std::uint32_t>(ents[k]), 32);
+                    prev_entities[k] = ents[k];
+                }
+                detail::load_words(data[k], cur);
+                for (size_t q = 0; q < W; ++q) {
+                    detail::put_xor(w, cur[q] ^ prev_words[k * W + q], windows[q]);
+                    prev_words[k * W + q] = cur[q];
+                }
+            }
+            last_end = j;
+            ++runs;
+            i = j;
+        }
+        w.flush();
+        prev_entities.resize(n);
+        prev_words.resize(n * W);
+
+        detail::DeltaHeader h{detail::kDeltaMagic, static_cast<std::uint32_t>(sizeof(T)), n, runs,
+                              out.size() - payload_at};
+        std::memcpy(out.data() + header_at, &h, sizeof h);
+        return out.size() - header_at;
+    }
+
+    // Forget the sent state; the next message carries the whole pool.
+    void reset() {
+        prev_entities.clear();
+        prev_words.clear();
+    }
+};
+
+// Total size of the message starting at `header` (header plus payload).
+inline size_t delta_message_size(const std::byte* header) {
+    detail::DeltaHeader h;
+    std::memcpy(&h, header, sizeof h);
+    if (h.magic != detail::kDeltaMagic) throw std::runtime_error("delta_message_size: bad magic");
+    if (h.payload_bytes > SIZE_MAX - sizeof h) throw std::runtime_error("delta_message_size: payload size overflows");
+    return sizeof h + h.payload_bytes;
+}
+
+// Apply one message from DeltaEncoder<T> to `mirror`, which must hold the
+// state the encoder last sent (initially empty). Returns the bytes consumed.
+// The whole message is decoded and checked before the mirror is touched, so
+// a malformed one throws and leaves the mirror as it was.
+template <typename T>
+size_t apply_delta(ComponentPool<T>& mirror, std::span<const std::byte> msg) {
+    static_assert(std::is_trivially_copyable_v<T>, "apply_delta: component must be trivially copyable");
+    constexpr size_t W = detail::kDeltaWords<T>;
+
+    detail::DeltaHeader h;
+    if (msg.size() < sizeof h) throw std::runtime_error("apply_delta: truncated header");
+    std::memcpy(&h, msg.data(), sizeof h);
+    if (h.magic != detail::kDeltaMagic || h.component_size != sizeof(T))
+        throw std::runtime_error("apply_delta: message is not a delta for this component type");
+    if (h.payload_bytes > msg.size() - sizeof h) throw std::runtime_error("apply_delta: truncated payload");
+
+    // Slots below `kept` survive the truncation and are XOR bases; the rest
+    // must be appended in order, exactly up to the new slot count
+    const size_t n = static_cast<size_t>(h.slot_count);
+    const size_t kept = n < mirror.size() ? n : mirror.size();
+    size_t next_new = kept;
+
+    std::vector<size_t>        slots;
+    std::vector<int>           entities;
+    std::vector<std::uint64_t> values;   // W words per decoded slot
+
+    detail::BitReader r(msg.data() + sizeof h, msg.data() + sizeof h + h.payload_bytes);
+    std::vector<detail::XorWindow> windows(W);
+    std::uint64_t words[W];
+    size_t pos = 0;
+    for (std::uint64_t run = 0; run < h.run_count; ++run) {
+        const std::uint64_t gap = detail::get_varint(r);
+        if (gap > n - pos) throw std::runtime_error("apply_delta: run past the end of the pool");
+        pos += gap;
+        const std::uint64_t len = detail::get_varint(r);
+        if (len > n - pos) throw std::runtime_error("apply_delta: run past the end of the pool");
+        for (size_t k = pos; k < pos + len; ++k) {
+            const bool present = k < kept;
+            if (!present && k != next_new++) throw std::runtime_error("apply_delta: mirror is out of sync with the encoder");
+            int entity = present ? mirror.entities()[k] : -1;
+            if (r.bit()) entity = static_cast<int>(static_cast<std::uint32_t>(r.get(32)));
+            if (entity < 0) throw std::runtime_error("apply_delta: new slot without an entity id");
+            if (present) detail::load_words(mirror.components()[k], words);
+            else         std::memset(words, 0, sizeof words);
+            for (size_t q = 0; q < W; ++q) words[q] ^= detail::get_xor(r, windows[q]);
+
+            slots.push_back(k);
+            entities.push_back(entity);
+            values.insert(values.end(), words, words + W);
+        }
+        pos += len;
+    }
+    if (next_new != n) throw std::runtime_error("apply_delta: mirror is out of sync with the encoder");
+
+    mirror.truncate(kept);
+    for (size_t i = 0; i < slots.size(); ++i) {
+        alignas(T) std::byte buf[sizeof(T)];
+        std::memcpy(buf, &values[i * W], sizeof(T));
+        mirror.place(slots[i], entities[i], *std::launder(reinterpret_cast<T*>(buf)));
+    }
+    return sizeof h + h.payload_bytes;
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include "ecs.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// Ring buffer of past registry states for rewind-and-resimulate.
+//
+// A full copy of every pool (the "shadow") is kept as of the latest capture.
+// Each capture compares the pools' sparse / entity_map / dense bytes with the
+// shadow page by page and stores only the pages that changed, as undo records
+// against the previous capture. Memory therefore grows with the number of
+// dirty pages per tick, not with world size. All components must be
+// trivially copyable.
+class RollbackBuffer {
+    // Turns one raw array at capture k back into its state at capture k-1
+    struct SectionUndo {
+        size_t old_size = 0;               // bytes
+        std::vector<std::uint32_t> pages;  // page indices, ascending
+        std::vector<std::size_t>   lengths;
+        std::vector<std::byte>     data;   // old page contents, concatenated
+    };
+    struct PoolUndo {
+        int pool_id;
+        SectionUndo sections[3];
+    };
+    struct Frame {
+        std::vector<PoolUndo> pools;
+        size_t bytes = 0;
+    };
+    struct Shadow {
+        BasePool* pool = nullptr;
+        std::vector<std::byte> sections[3];
+    };
+
+    Registry& reg;
+    size_t page_size;
+    std::vector<Frame> ring;
+    size_t head  = 0;   // slot of the newest frame
+    size_t count = 0;
+    std::unordered_map<int, Shadow> shadows;
+
+    static std::pair<const std::byte*, size_t> section_bytes(const BasePool& pool, int s) {
+        switch (s) {
+            case 0:  return {reinterpret_cast<const std::byte*>(pool.sparse_array().data()), pool.sparse_array().size() * sizeof(int)};
+            case 1:  return {reinterpret_cast<const std::byte*>(pool.entity_array().data()), pool.entity_array().size() * sizeof(int)};
+            default: return {static_cast<const std::byte*>(pool.dense_data()), pool.size() * pool.component_size()};
+        }
+    }
+
+    // Record the pages of `shadow` that differ from `cur` into `undo`, then
+    // bring `shadow` up to date. Returns the number of undo bytes stored.
+    size_t diff(std::vector<std::byte>& shadow, const std::byte* cur, size_t cur_size, SectionUndo& undo) const {
+        const size_t old_size = shadow.size();
+        undo.old_size = old_size;
+        undo.pages.clear();
+        undo.lengths.clear();
+        undo.data.clear();
+        for (size_t begin = 0; begin < old_size; begin += page_size) {
+            const size_t old_len = std::min(page_size, old_size - begin);
+            const size_t cur_len = begin < cur_size ? std::min(page_size, cur_size - begin) : 0;
+            if (old_len == cur_len && std::memcmp(shadow.data() + begin, cur + begin, old_len) == 0) continue;
+            undo.pages.push_back(static_cast<std::uint32_t>(begin / page_size));
+            undo.lengths.push_back(old_len);
+            undo.data.insert(undo.data.end(), shadow.begin() + begin, shadow.begin() + begin + old_len);
+            std::memcpy(shadow.data() + begin, cur + begin, std::min(old_len, cur_len));
+        }
+        shadow.resize(cur_size);
+        if (cur_size > old_size) std::memcpy(shadow.data() + old_size, cur + old_size, cur_size - old_size);
+        return undo.data.size() + undo.pages.size() * (sizeof(std::uint32_t) + sizeof(std::size_t));
+    }
+
+    void undo(std::vector<std::byte>& shadow, const SectionUndo& u) const {
+        shadow.resize(u.old_size);
+        const std::byte* src = u.data.data();
+        for (size_t i = 0; i < u.pages.size(); ++i) {
+            std::memcpy(shadow.data() + size_t(u.pages[i]) * page_size, src, u.lengths[i]);
+            src += u.lengths[i];
+        }
+    }
+
+public:
+    // Keep up to `capacity` captured ticks; the oldest is dropped when full.
+    explicit RollbackBuffer(Registry& registry, size_t capacity, size_t page_bytes = 4096)
+        : reg(registry), page_size(page_bytes), ring(capacity) {
+        if (capacity == 0) throw std::invalid_argument("RollbackBuffer: capacity must be positive");
+        if (page_bytes == 0) throw std::invalid_argument("RollbackBuffer: page size must be positive");
+    }
+
+    // Record the registry's current component state as the newest tick.
+    void capture() {
+        reg.for_each_pool([](int, BasePool& pool) {
+            if (!pool.trivially_copyable())
+                throw std::logic_error("RollbackBuffer::capture: component is not trivially copyable");
+        });
+
+        head = count == 0 ? 0 : (head + 1) % ring.size();
+        count = std::min(count + 1, ring.size());
+        Frame& f = ring[head];
+        f.bytes = 0;
+        size_t n = 0;
+        reg.for_each_pool([&](int id, BasePool& pool) {
+            Shadow& sh = shadows[id];
+            sh.pool = &pool;
+            if (n == f.pools.size()) f.pools.emplace_back();
+            PoolUndo& pu = f.pools[n++];
+            pu.pool_id = id;
+            for (int s = 0; s < 3; ++s) {
+                auto [bytes, size] = section_bytes(pool, s);
+                f.bytes += diff(sh.sections[s], bytes, size, pu.sections[s]);
+            }
+        });
+        f.pools.resize(n);
+
+        // The oldest frame's undo records lead to a state no longer kept
+        if (count == ring.size()) {
+            Frame& oldest = ring[(head + 1) % ring.size()];
+            oldest.pools.clear();
+            oldest.bytes = 0;
+        }
+    }
+
+    // Restore the state captured `ticks` captures before the newest one
+    // (0 = the newest, discarding changes made since). Later captures are
+    // dropped, so resimulation continues from the restored tick.
+    void rewind(size_t ticks) {
+        if (ticks >= count) throw std::out_of_range("RollbackBuffer::rewind: not enough history");
+        for (size_t t = 0; t < ticks; ++t) {
+            Frame& f = ring[head];
+            for (const PoolUndo& pu : f.pools)
+                for (int s = 0; s < 3; ++s) undo(shadows[pu.pool_id].sections[s], pu.sections[s]);
+            f.pools.clear();
+            f.bytes = 0;
+            head = (head + ring.size() - 1) % ring.size();
+            --count;
+        }
+        // Pools created after the restored tick have no shadow; they existed empty then
+        reg.for_each_pool([&](int id, BasePool& pool) {
+            if (!shadows.count(id)) pool.clear();
+        });
+        for (auto& [id, sh] : shadows) {
+            auto& sec = sh.sections;
+            sh.pool->assign_raw(reinterpret_cast<const int*>(sec[0].data()), sec[0].size() / sizeof(int),
+                                reinterpret_cast<const int*>(sec[1].data()), sec[1].size() / sizeof(int),
+                                sec[2].data(), sec[2].size() / sh.pool->component_size());
+        }
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return ring.size(); }
+
+    // Bytes held by the shadow copy of the newest tick
+    size_t baseline_bytes() const {
+        size_t total = 0;
+        for (const auto& [id, sh] : shadows)
+            for (const auto& sec : sh.sections) total += sec.size();
+        return total;
+    }
+
+    // Bytes held by undo records (changed pages and their indices) for older ticks
+    size_t delta_bytes() const {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) total += ring[(head + ring.size() - i) % ring.size()].bytes;
+        return total;
+    }
+
+    size_t memory_usage() const { return baseline_bytes() + delta_bytes(); }
+};
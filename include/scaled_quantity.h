@@ -0,0 +1,255 @@
+#pragma once
+#include "units.h"
+#include <compare>
+#include <cstdint>
+#include <numeric>
+#include <ratio>
+#include <type_traits>
+
+// A quantity stored in a non-SI unit whose size is an exact compile-time
+// ratio of the SI unit: ScaledQuantity<Length::DimensionType, scale::ft>
+// holds a number of feet.
+//
+// The ratio lives in the type, so conversions between scales multiply by a
+// factor computed at compile time from exact std::ratio arithmetic — one
+// multiply, or none when the scales agree. Products and quotients of scaled
+// quantities multiply the ratios, not the values, so a formula evaluated in
+// feet and pounds pays for the conversion to SI once, at the end.
+//
+// Only linear units fit here. Affine scales such as °F have an offset as
+// well as a ratio and stay with the _degF literal.
+
+template <typename Dim, typename Ratio, typename Rep = double>
+struct ScaledQuantity;
+
+namespace detail {
+    // v · From/To, with the factor folded to one constant. An integer Rep
+    // multiplies by the numerator before dividing by the denominator, since
+    // the folded factor would truncate to zero; the result truncates.
+    template <typename From, typename To, typename Rep>
+    constexpr Rep rescale(Rep v) {
+        using F = std::ratio_divide<From, To>;
+        if constexpr (F::num == 1 && F::den == 1) return v;
+        else if constexpr (F::den == 1)           return static_cast<Rep>(v * static_cast<Rep>(F::num));
+        else if constexpr (std::is_integral_v<Rep>)
+            return static_cast<Rep>(v * static_cast<Rep>(F::num) / static_cast<Rep>(F::den));
+        else                                      return v * (static_cast<Rep>(F::num) / static_cast<Rep>(F::den));
+    }
+
+    // Whether rescaling From to To in Rep loses nothing, as std::chrono
+    // decides: a floating-point Rep, or a whole-number factor
+    template <typename From, typename To, typename Rep>
+    inline constexpr bool exact_rescale_v = std::is_floating_point_v<Rep> || std::ratio_divide<From, To>::den == 1;
+
+    // Largest ratio both R1 and R2 are integer multiples of, as in std::chrono
+    template <typename R1, typename R2>
+    using common_ratio = std::ratio<std::gcd(R1::num, R2::num), std::lcm(R1::den, R2::den)>;
+
+    template <typename T>
+    struct is_scaled_quantity : std::false_type {};
+    template <typename Dim, typename Ratio, typename Rep>
+    struct is_scaled_quantity<ScaledQuantity<Dim, Ratio, Rep>> : std::true_type {};
+
+    // Scale of a scaled or SI quantity (SI is ratio 1)
+    template <typename Q>
+    struct scale_of { using type = std::ratio<1>; };
+    template <typename Dim, typename Ratio, typename Rep>
+    struct scale_of<ScaledQuantity<Dim, Ratio, Rep>> { using type = Ratio; };
+}
+
+template <typename T>
+concept IsScaledQuantity = detail::is_scaled_quantity<T>::value;
+
+// A scaled or SI quantity — the operands the scaled operators accept
+template <typename T>
+concept IsAnyQuantity = IsScaledQuantity<T> || IsQuantity<T>;
+
+template <typename Dim, typename Ratio, typename Rep>
+struct ScaledQuantity {
+    static_assert(Ratio::num > 0, "ScaledQuantity: scale must be positive");
+
+    using DimensionType = Dim;
+    using RepType       = Rep;
+    using ScaleType     = typename Ratio::type;
+    Rep value;
+
+    explicit constexpr ScaledQuantity(Rep v) : value(v) {}
+
+    // Another scale of the same dimension: one multiply by the exact ratio of
+    // the two scales, none when they are equal. Implicit only when nothing is
+    // lost — the same Rep, and a floating-point Rep or a whole-number factor —
+    // as for std::chrono::duration; a change of Rep is always explicit.
+    template <typename R2, typename Rep2>
+    explicit(!(std::is_same_v<Rep, Rep2> && detail::exact_rescale_v<R2, Ratio, Rep>))
+    constexpr ScaledQuantity(ScaledQuantity<Dim, R2, Rep2> q)
+        : value(detail::rescale<R2, Ratio>(static_cast<Rep>(q.value))) {}
+
+    // From SI — explicit, so a stray Quantity is never silently re-scaled
+    explicit constexpr ScaledQuantity(Quantity<Dim, Rep> q)
+        : value(detail::rescale<std::ratio<1>, Ratio>(q.value)) {}
+
+    // To SI: one multiply by the scale; implicit on the same terms as above
+    constexpr Quantity<Dim, Rep> si() const { return Quantity<Dim, Rep>(detail::rescale<Ratio, std::ratio<1>>(value)); }
+    explicit(!detail::exact_rescale_v<Ratio, std::ratio<1>, Rep>)
+    constexpr operator Quantity<Dim, Rep>() const { return si(); }
+
+    constexpr ScaledQuantity operator-() const { return ScaledQuantity(-value); }
+
+    // Scalars follow Quantity's rule: an arithmetic scalar of another type
+    // computes in std::common_type_t<Rep, S>
+    constexpr ScaledQuantity operator*(Rep s) const { return ScaledQuantity(value * s); }
+    friend constexpr ScaledQuantity operator*(Rep s, ScaledQuantity q) { return ScaledQuantity(s * q.value); }
+    constexpr ScaledQuantity operator/(Rep s) const { return ScaledQuantity(value / s); }
+
+    template <typename S>
+        requires std::is_arithmetic_v<S> && (!std::is_same_v<S, Rep>)
+    constexpr auto operator*(S s) const {
+        using R = detail::scalar_rep_t<Rep, S>;
+        return ScaledQuantity<Dim, Ratio, R>(static_cast<R>(value) * static_cast<R>(s));
+    }
+    template <typename S>
+        requires std::is_arithmetic_v<S> && (!std::is_same_v<S, Rep>)
+    friend constexpr auto operator*(S s, ScaledQuantity q) {
+        using R = detail::scalar_rep_t<Rep, S>;
+        return ScaledQuantity<Dim, Ratio, R>(static_cast<R>(s) * static_cast<R>(q.value));
+    }
+    template <typename S>
+        requires std::is_arithmetic_v<S> && (!std::is_same_v<S, Rep>)
+    constexpr auto operator/(S s) const {
+        using R = detail::scalar_rep_t<Rep, S>;
+        return ScaledQuantity<Dim, Ratio, R>(static_cast<R>(value) / static_cast<R>(s));
+    }
+};
+
+// unit_cast<Ratio>(q) — the same quantity expressed in another scale
+template <typename Ratio, typename Q>
+    requires IsAnyQuantity<Q>
+constexpr auto unit_cast(Q q) {
+    using R = typename Q::RepType;
+    return ScaledQuantity<typename Q::DimensionType, typename Ratio::type, R>(
+        detail::rescale<typename detail::scale_of<Q>::type, Ratio>(q.value));
+}
+
+// Sums and differences are expressed in the common scale of the operands,
+// so each side needs at most one exact integer multiply
+template <typename Dim, typename R1, typename R2, typename Rep1, typename Rep2>
+constexpr auto operator+(ScaledQuantity<Dim, R1, Rep1> a, ScaledQuantity<Dim, R2, Rep2> b) {
+    using C = detail::common_ratio<R1, R2>;
+    using R = std::common_type_t<Rep1, Rep2>;
+    return ScaledQuantity<Dim, C, R>(detail::rescale<R1, C>(static_cast<R>(a.value)) + detail::rescale<R2, C>(static_cast<R>(b.value)));
+}
+
+template <typename Dim, typename R1, typename R2, typename Rep1, typename Rep2>
+constexpr auto operator-(ScaledQuantity<Dim, R1, Rep1> a, ScaledQuantity<Dim, R2, Rep2> b) {
+    using C = detail::common_ratio<R1, R2>;
+    using R = std::common_type_t<Rep1, Rep2>;
+    return ScaledQuantity<Dim, C, R>(detail::rescale<R1, C>(static_cast<R>(a.value)) - detail::rescale<R2, C>(static_cast<R>(b.value)));
+}
+
+// Mixed with an SI quantity, the sum is SI
+template <typename Dim, typename Ratio, typename Rep1, typename Rep2>
+constexpr auto operator+(ScaledQuantity<Dim, Ratio, Rep1> a, Quantity<Dim, Rep2> b) { return a.si() + b; }
+template <typename Dim, typename Ratio, typename Rep1, typename Rep2>
+constexpr auto operator+(Quantity<Dim, Rep1> a, ScaledQuantity<Dim, Ratio, Rep2> b) { return a + b.si(); }
+template <typename Dim, typename Ratio, typename Rep1, typename Rep2>
+constexpr auto operator-(ScaledQuantity<Dim, Ratio, Rep1> a, Quantity<Dim, Rep2> b) { return a.si() - b; }
+template <typename Dim, typename Ratio, typename Rep1, typename Rep2>
+constexpr auto operator-(Quantity<Dim, Rep1> a, ScaledQuantity<Dim, Ratio, Rep2> b) { return a - b.si(); }
+
+// Products and quotients multiply the scales at compile time and the values
+// at run time; an SI operand has scale 1
+template <typename A, typename B>
+    requires IsAnyQuantity<A> && IsAnyQuantity<B> && (IsScaledQuantity<A> || IsScaledQuantity<B>)
+constexpr auto operator*(A a, B b) {
+    using R = std::common_type_t<typename A::RepType, typename B::RepType>;
+    using D = typename DimAdd<typename A::DimensionType, typename B::DimensionType>::type;
+    using S = std::ratio_multiply<typename detail::scale_of<A>::type, typename detail::scale_of<B>::type>;
+    return ScaledQuantity<D, typename S::type, R>(static_cast<R>(a.value) * static_cast<R>(b.value));
+}
+
+template <typename A, typename B>
+    requires IsAnyQuantity<A> && IsAnyQuantity<B> && (IsScaledQuantity<A> || IsScaledQuantity<B>)
+constexpr auto operator/(A a, B b) {
+    using R = std::common_type_t<typename A::RepType, typename B::RepType>;
+    using D = typename DimSub<typename A::DimensionType, typename B::DimensionType>::type;
+    using S = std::ratio_divide<typename detail::scale_of<A>::type, typename detail::scale_of<B>::type>;
+    return ScaledQuantity<D, typename S::type, R>(static_cast<R>(a.value) / static_cast<R>(b.value));
+}
+
+// Comparisons across scales compare in the common scale
+template <typename Dim, typename R1, typename R2, typename Rep1, typename Rep2>
+constexpr bool operator==(ScaledQuantity<Dim, R1, Rep1> a, ScaledQuantity<Dim, R2, Rep2> b) {
+    using C = detail::common_ratio<R1, R2>;
+    using R = std::common_type_t<Rep1, Rep2>;
+    return detail::rescale<R1, C>(static_cast<R>(a.value)) == detail::rescale<R2, C>(static_cast<R>(b.value));
+}
+
+template <typename Dim, typename R1, typename R2, typename Rep1, typename Rep2>
+constexpr auto operator<=>(ScaledQuantity<Dim, R1, Rep1> a, ScaledQuantity<Dim, R2, Rep2> b) {
+    using C = detail::common_ratio<R1, R2>;
+    using R = std::common_type_t<Rep1, Rep2>;
+    return detail::rescale<R1, C>(static_cast<R>(a.value)) <=> detail::rescale<R2, C>(static_cast<R>(b.value));
+}
+
+template <typename Dim, typename Ratio, typename Rep>
+std::ostream& operator<<(std::ostream& os, ScaledQuantity<Dim, Ratio, Rep> q) {
+    os << q.value << " [";
+    if constexpr (Ratio::num != 1 || Ratio::den != 1) {
+        os << Ratio::num;
+        if constexpr (Ratio::den != 1) os << '/' << Ratio::den;
+        os << " \xc2\xb7 ";
+    }
+    return os << dim_string_v<Dim> << "]";
+}
+
+// =============================================================================
+// Exact scales of common non-SI units, relative to the SI unit of their dimension
+// =============================================================================
+
+namespace scale {
+    // Each is reduced to lowest terms, so equal scales are the same type
+
+    // Length (m)
+    using km  = std::kilo;
+    using cm  = std::centi;
+    using mm  = std::milli;
+    using in  = std::ratio<254, 10000>::type;
+    using ft  = std::ratio_multiply<in, std::ratio<12>>;
+    using yd  = std::ratio_multiply<ft, std::ratio<3>>;
+    using mi  = std::ratio_multiply<yd, std::ratio<1760>>;
+    using nmi = std::ratio<1852>;
+
+    // Mass (kg)
+    using g  = std::milli;
+    using lb = std::ratio<45359237, 100000000>::type;
+    using oz = std::ratio_divide<lb, std::ratio<16>>;
+
+    // Time (s)
+    using min = std::ratio<60>;
+    using hr  = std::ratio<3600>;
+    using day = std::ratio<86400>;
+
+    // Volume (m³)
+    using L   = std::milli;
+    using gal = std::ratio<3785411784, 1000000000000>::type;   // US gallon
+
+    // Force (N), pressure (Pa), energy (J)
+    using lbf = std::ratio_multiply<lb, std::ratio<980665, 100000>>;   // lb · g_n
+    using psi = std::ratio_divide<lbf, std::ratio_multiply<in, in>>;
+    using bar = std::ratio<100000>;
+    using atm = std::ratio<101325>;
+    using kWh = std::ratio<3600000>;
+    using cal = std::ratio<4184, 1000>::type;
+}
+
+using Kilometres = ScaledQuantity<Length::DimensionType,   scale::km>;
+using Inches     = ScaledQuantity<Length::DimensionType,   scale::in>;
+using Feet       = ScaledQuantity<Length::DimensionType,   scale::ft>;
+using Yards      = ScaledQuantity<Length::DimensionType,   scale::yd>;
+using Miles      = ScaledQuantity<Length::DimensionType,   scale::mi>;
+using Pounds     = ScaledQuantity<Mass::DimensionType,     scale::lb>;
+using Hours      = ScaledQuantity<Time::DimensionType,     scale::hr>;
+using Litres     = ScaledQuantity<Volume::DimensionType,   scale::L>;
+using Gallons    = ScaledQuantity<Volume::DimensionType,   scale::gal>;
+using PoundsForce = ScaledQuantity<Force::DimensionType,   scale::lbf>;
+using Psi        = ScaledQuantity<Pressure::DimensionType, scale::psi>;
@@ -0,0 +1,129 @@
+#pragma once
+#include "units.h"
+#include "quantity_vector.h"
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+// Bulk conversion of raw readings in a named unit to SI quantities.
+//
+// unit::psi, unit::degF, unit::ft, ... describe every literal in units.h as
+// `si = raw · factor + offset`. convert<unit::psi>(raw) turns a span of plain
+// doubles into a QuantityVector<Pressure::DimensionType> in one pass over
+// simd::Pack lanes, with a scalar tail; convert<U>(raw, out) writes into
+// existing storage instead.
+//
+// The linear descriptors take their factor from the literal itself
+// ((1.0_psi).value), so a bulk conversion multiplies by exactly the constant
+// the literal does and the two can never drift apart. The affine temperature
+// scales are written out by hand: _degF computes (v − 32) · 5/9 + 273.15 in
+// long double, the kernel folds that to one multiply and one add in double,
+// and the results agree to within a few ulp.
+
+template <typename U>
+concept UnitDescriptor = requires {
+    typename U::quantity;
+    { U::factor } -> std::convertible_to<double>;
+    { U::offset } -> std::convertible_to<double>;
+} && IsQuantity<typename U::quantity>;
+
+// Every linear literal in units.h, by name without the underscore. A literal
+// added there needs one entry here; unit:: and the parse_quantity symbol table
+// (quantity_parse.h) are both generated from this list.
+#define DAL_FOR_EACH_LINEAR_UNIT(X)                                                     \
+    /* Mass */                                                                          \
+    X(kg) X(g) X(mg) X(Da) X(u) X(tonne) X(lb) X(lbm) X(oz) X(slug)                     \
+    /* Length */                                                                        \
+    X(m) X(km) X(cm) X(mm) X(in) X(ft) X(yd) X(mi) X(nmi) X(au) X(ly) X(pc) X(kpc)      \
+    X(Mpc)                                                                              \
+    /* Time */                                                                          \
+    X(s) X(ms) X(us) X(min) X(hr) X(day) X(yr)                                          \
+    /* Current, temperature, amount, luminosity */                                      \
+    X(A) X(mA) X(uA) X(nA) X(K) X(mol) X(mmol) X(cd)                                    \
+    /* Force, energy, power */                                                          \
+    X(N) X(kN) X(lbf) X(J) X(kJ) X(cal) X(kcal) X(eV) X(meV) X(MeV) X(GeV) X(Wh)        \
+    X(kWh) X(BTU) X(W) X(kW) X(MW) X(hp)                                                \
+    /* Pressure */                                                                      \
+    X(Pa) X(kPa) X(MPa) X(bar) X(atm) X(psi) X(torr) X(mmHg)                            \
+    /* Frequency, volume, area, velocity */                                             \
+    X(Hz) X(kHz) X(MHz) X(GHz) X(L) X(mL) X(b) X(kn)                                    \
+    /* Electromagnetism */                                                              \
+    X(MV) X(kV) X(V) X(mV) X(uV) X(C) X(mC) X(uC) X(nC) X(pC) X(Wb) X(T)                \
+    X(H) X(mH) X(uH) X(nH) X(F) X(mF) X(uF) X(nF) X(pF)                                 \
+    X(Mohm) X(kohm) X(ohm) X(mohm) X(S)                                                 \
+    /* Radiation, photometry */                                                         \
+    X(Bq) X(Ci) X(Gy) X(Sv) X(lm) X(lx)                                                 \
+    /* Angle, information, data rate */                                                 \
+    X(rad) X(mrad) X(deg) X(rpm) X(bit) X(kbit) X(Mbit) X(Gbit)                         \
+    X(B) X(kB) X(MB) X(GB) X(KiB) X(MiB) X(GiB) X(bps) X(kbps) X(Mbps) X(Gbps)
+
+namespace unit {
+
+#define DAL_LINEAR_UNIT(name)                                                       \
+    struct name {                                                                   \
+        using quantity = decltype(1.0_##name);                                      \
+        static constexpr double factor = (1.0_##name).value;                        \
+        static constexpr double offset = 0.0;                                       \
+        static_assert((0.0_##name).value == 0.0, "unit::" #name ": literal is not linear"); \
+    };
+
+    DAL_FOR_EACH_LINEAR_UNIT(DAL_LINEAR_UNIT)
+
+#undef DAL_LINEAR_UNIT
+
+    // Affine temperature scales
+    struct degC {
+        using quantity = Temperature;
+        static constexpr double factor = 1.0;
+        static constexpr double offset = 273.15;
+    };
+    struct degF {
+        using quantity = Temperature;
+        static constexpr double factor = 5.0 / 9.0;
+        static constexpr double offset = 273.15 - 32.0 * (5.0 / 9.0);
+    };
+}
+
+namespace detail {
+    // raw · factor + offset on a double or a simd::Pack, skipping identity steps
+    template <typename U, typename T>
+    inline T to_si(T x) {
+        if constexpr (U::factor != 1.0) x = x * T(U::factor);
+        if constexpr (U::offset != 0.0) x = x + T(U::offset);
+        return x;
+    }
+}
+
+// Convert raw readings in unit U into existing storage of the same length.
+// Sizes that differ throw std::invalid_argument.
+template <UnitDescriptor U>
+void convert(std::span<const double> raw, std::span<typename U::quantity> out) {
+    using Q = typename U::quantity;
+    static_assert(sizeof(Q) == sizeof(double) && std::is_same_v<typename Q::RepType, double>);
+    if (raw.size() != out.size()) throw std::invalid_argument("convert: size mismatch");
+    const std::size_t n = raw.size();
+    const double* in  = raw.data();
+    double*       dst = &out.data()->value;
+    if constexpr (U::factor == 1.0 && U::offset == 0.0) {
+        if (n) std::memcpy(dst, in, n * sizeof(double));
+    } else {
+        constexpr int N = simd::kNativeLanes<double>;
+        using P = simd::Pack<double, N>;
+        std::size_t i = 0;
+        for (; i + 2 * N <= n; i += 2 * N) {
+            detail::to_si<U>(P::load(in + i)).store(dst + i);
+            detail::to_si<U>(P::load(in + i + N)).store(dst + i + N);
+        }
+        for (; i < n; ++i) dst[i] = detail::to_si<U>(in[i]);
+    }
+}
+
+// Convert raw readings in unit U to a new vector of SI quantities
+template <UnitDescriptor U>
+QuantityVector<typename U::quantity::DimensionType> convert(std::span<const double> raw) {
+    using V = QuantityVector<typename U::quantity::DimensionType>;
+    V out(typename V::uninitialized_t{}, raw.size());
+    convert<U>(raw, out.span());
+    return out;
+}
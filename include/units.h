@@ -78,6 +78,43 @@ using AbsorbedDose        = Quantity<Dimensions<0,2,-2>>; // J/kg — Gray (Gy),
 using LuminousFlux = Luminosity;                                  // lm = cd·sr (sr dimensionless)
 using Illuminance  = Quantity<Dimensions<0,-2,0,0,0,0,1>>;        // lx = cd/m²
 
+// =============================================================================
+// Named SI Derived Units — symbols for named(q) and the 'n' format spec
+// =============================================================================
+// Only dimensions with a single SI name: Frequency prints Hz (not Bq), and
+// AbsorbedDose, which shares m²·s⁻² with a squared velocity, keeps base units.
+
+template <> struct UnitSymbol<Force::DimensionType>             { static constexpr const char* symbol = "N"; };
+template <> struct UnitSymbol<Energy::DimensionType>            { static constexpr const char* symbol = "J"; };
+template <> struct UnitSymbol<Power::DimensionType>             { static constexpr const char* symbol = "W"; };
+template <> struct UnitSymbol<Pressure::DimensionType>          { static constexpr const char* symbol = "Pa"; };
+template <> struct UnitSymbol<Frequency::DimensionType>         { static constexpr const char* symbol = "Hz"; };
+template <> struct UnitSymbol<Charge::DimensionType>            { static constexpr const char* symbol = "C"; };
+template <> struct UnitSymbol<Voltage::DimensionType>           { static constexpr const char* symbol = "V"; };
+template <> struct UnitSymbol<Resistance::DimensionType>        { static constexpr const char* symbol = "\xce\xa9"; };   // Ω
+template <> struct UnitSymbol<Capacitance::DimensionType>       { static constexpr const char* symbol = "F"; };
+template <> struct UnitSymbol<Inductance::DimensionType>        { static constexpr const char* symbol = "H"; };
+template <> struct UnitSymbol<MagneticFlux::DimensionType>      { static constexpr const char* symbol = "Wb"; };
+template <> struct UnitSymbol<MagneticField::DimensionType>     { static constexpr const char* symbol = "T"; };
+template <> struct UnitSymbol<Conductance::DimensionType>       { static constexpr const char* symbol = "S"; };
+template <> struct UnitSymbol<CatalyticActivity::DimensionType> { static constexpr const char* symbol = "kat"; };
+template <> struct UnitSymbol<Illuminance::DimensionType>       { static constexpr const char* symbol = "lx"; };
+
+// =============================================================================
+// Extension Base Dimensions — slots of BaseDim; 3–7 are free for users
+// =============================================================================
+
+template <> struct BaseDimension<0> { static constexpr const char* symbol = "rad"; };
+template <> struct BaseDimension<1> { static constexpr const char* symbol = "bit"; };
+template <> struct BaseDimension<2> { static constexpr const char* symbol = "count"; };
+
+using Angle           = Quantity<BaseDim<0>>;                                  // rad (SI: dimensionless)
+using Information     = Quantity<BaseDim<1>>;                                  // bit
+using Count           = Quantity<BaseDim<2>>;                                  // events, items, cycles
+using AngularVelocity = Quantity<DimSub<BaseDim<0>, Dimensions<0,0,1>>::type>; // rad/s
+using DataRate        = Quantity<DimSub<BaseDim<1>, Dimensions<0,0,1>>::type>; // bit/s
+using EventRate       = Quantity<DimSub<BaseDim<2>, Dimensions<0,0,1>>::type>; // count/s
+
 // =============================================================================
 // Physical Constants (2019 SI redefinition — exact values; CODATA 2018 measured)
 // =============================================================================
@@ -373,4 +410,48 @@ constexpr LuminousFlux operator""_lm (unsigned long long v){ return LuminousFlux
 constexpr Illuminance  operator""_lx (long double v)      { return Illuminance(static_cast<double>(v)); }
 constexpr Illuminance  operator""_lx (unsigned long long v){ return Illuminance(static_cast<double>(v)); }
 
+// --- Angle ---
+constexpr Angle           operator""_rad  (long double v)      { return Angle(static_cast<double>(v)); }
+constexpr Angle           operator""_rad  (unsigned long long v){ return Angle(static_cast<double>(v)); }
+constexpr Angle           operator""_mrad (long double v)      { return Angle(static_cast<double>(v) * 1e-3); }
+constexpr Angle           operator""_mrad (unsigned long long v){ return Angle(static_cast<double>(v) * 1e-3); }
+constexpr Angle           operator""_deg  (long double v)      { return Angle(static_cast<double>(v) * 0.017453292519943295); }
+constexpr Angle           operator""_deg  (unsigned long long v){ return Angle(static_cast<double>(v) * 0.017453292519943295); }
+constexpr AngularVelocity operator""_rpm  (long double v)      { return AngularVelocity(static_cast<double>(v) * 0.10471975511965977); }
+constexpr AngularVelocity operator""_rpm  (unsigned long long v){ return AngularVelocity(static_cast<double>(v) * 0.10471975511965977); }
+
+// --- Information ---
+constexpr Information     operator""_bit  (long double v)      { return Information(static_cast<double>(v)); }
+constexpr Information     operator""_bit  (unsigned long long v){ return Information(static_cast<double>(v)); }
+constexpr Information     operator""_kbit (long double v)      { return Information(static_cast<double>(v) * 1e3); }
+constexpr Information     operator""_kbit (unsigned long long v){ return Information(static_cast<double>(v) * 1e3); }
+constexpr Information     operator""_Mbit (long double v)      { return Information(static_cast<double>(v) * 1e6); }
+constexpr Information     operator""_Mbit (unsigned long long v){ return Information(static_cast<double>(v) * 1e6); }
+constexpr Information     operator""_Gbit (long double v)      { return Information(static_cast<double>(v) * 1e9); }
+constexpr Information     operator""_Gbit (unsigned long long v){ return Information(static_cast<double>(v) * 1e9); }
+constexpr Information     operator""_B    (long double v)      { return Information(static_cast<double>(v) * 8); }
+constexpr Information     operator""_B    (unsigned long long v){ return Information(static_cast<double>(v) * 8); }
+constexpr Information     operator""_kB   (long double v)      { return Information(static_cast<double>(v) * 8e3); }
+constexpr Information     operator""_kB   (unsigned long long v){ return Information(static_cast<double>(v) * 8e3); }
+constexpr Information     operator""_MB   (long double v)      { return Information(static_cast<double>(v) * 8e6); }
+constexpr Information     operator""_MB   (unsigned long long v){ return Information(static_cast<double>(v) * 8e6); }
+constexpr Information     operator""_GB   (long double v)      { return Information(static_cast<double>(v) * 8e9); }
+constexpr Information     operator""_GB   (unsigned long long v){ return Information(static_cast<double>(v) * 8e9); }
+constexpr Information     operator""_KiB  (long double v)      { return Information(static_cast<double>(v) * 8192.0); }
+constexpr Information     operator""_KiB  (unsigned long long v){ return Information(static_cast<double>(v) * 8192.0); }
+constexpr Information     operator""_MiB  (long double v)      { return Information(static_cast<double>(v) * 8388608.0); }
+constexpr Information     operator""_MiB  (unsigned long long v){ return Information(static_cast<double>(v) * 8388608.0); }
+constexpr Information     operator""_GiB  (long double v)      { return Information(static_cast<double>(v) * 8589934592.0); }
+constexpr Information     operator""_GiB  (unsigned long long v){ return Information(static_cast<double>(v) * 8589934592.0); }
+
+// --- Data rate ---
+constexpr DataRate        operator""_bps  (long double v)      { return DataRate(static_cast<double>(v)); }
+constexpr DataRate        operator""_bps  (unsigned long long v){ return DataRate(static_cast<double>(v)); }
+constexpr DataRate        operator""_kbps (long double v)      { return DataRate(static_cast<double>(v) * 1e3); }
+constexpr DataRate        operator""_kbps (unsigned long long v){ return DataRate(static_cast<double>(v) * 1e3); }
+constexpr DataRate        operator""_Mbps (long double v)      { return DataRate(static_cast<double>(v) * 1e6); }
+constexpr DataRate        operator""_Mbps (unsigned long long v){ return DataRate(static_cast<double>(v) * 1e6); }
+constexpr DataRate        operator""_Gbps (long double v)      { return DataRate(static_cast<double>(v) * 1e9); }
+constexpr DataRate        operator""_Gbps (unsigned long long v){ return DataRate(static_cast<double>(v) * 1e9); }
+
 } // inline namespace si_literals
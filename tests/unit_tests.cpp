@@ -1,9 +1,29 @@
 #include <gtest/gtest.h>
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <limits>
+#include <fstream>
+#include <iterator>
 #include <sstream>
+#include <string>
+#include <typeinfo>
 #include "units.h"
+#include "fixed_point.h"
+#include "scaled_quantity.h"
+#include "unit_convert.h"
+#include "dyn_quantity.h"
+#include "quantity_format.h"
+#include "quantity_pack.h"
+#include "quantity_parse.h"
+#include "quantity_vector.h"
+#include "quantity_reduce.h"
+#include "quantity_filter.h"
+#include "quantity_sort.h"
 #include "ecs.h"
+#include "hierarchy.h"
+#include "rollback.h"
+#include "replication.h"
 
 // =============================================================================
 // DimEngine — all 7 slots propagate through DimAdd / DimSub
@@ -1312,6 +1332,17 @@ TEST(ECSEdgeCases, ViewMutatesComponents) {
     EXPECT_EQ(reg.get_pool<int>().get(1), 40);
 }
 
+TEST(ECSEdgeCases, ReorderKeepsStaleDuplicatesOrphaned) {
+    ComponentPool<int> pool;
+    pool.assign(0, 1);
+    pool.assign(1, 2);
+    pool.assign(0, 3);                 // duplicate — get(0) now returns 3
+    pool.reorder({1});
+    EXPECT_EQ(pool.get(0), 3);
+    EXPECT_EQ(pool.get(1), 2);
+    EXPECT_EQ(pool.entities().front(), 1);
+}
+
 // =============================================================================
 // ConstexprEval — arithmetic evaluable at compile time
 // =============================================================================
@@ -1354,6 +1385,26 @@ TEST(ConstexprEval, AdditionAndSubtractionAreConstexpr) {
     static_assert((e1 - e2).value == 7.0);
 }
 
+TEST(ConstexprEval, PowIsConstexpr) {
+    constexpr Area   a = pow<2>(3.0_m);
+    constexpr Volume v = pow<3>(2.0_m);
+    constexpr auto   inv = pow<-2>(2.0_s);
+    static_assert(a.value == 9.0);
+    static_assert(v.value == 8.0);
+    static_assert(inv.value == 0.25);
+    static_assert(pow<0>(5.0_kg).value == 1.0);
+    static_assert(pow<15>(Length(2.0)).value == 32768.0);
+    EXPECT_DOUBLE_EQ(pow<7>(Length(1.5)).value, std::pow(1.5, 7));
+}
+
+TEST(ConstexprEval, PowChainIsShortest) {
+    static_assert(detail::chain_cost(2) == 1);
+    static_assert(detail::chain_cost(8) == 3);
+    static_assert(detail::chain_cost(7) == 4);
+    static_assert(detail::chain_cost(15) == 5);   // (x^3)^5, not square-and-multiply's 6
+    static_assert(pow<15>(RebindRep<Length, std::int64_t>(3)).value == 14348907);
+}
+
 // =============================================================================
 // StreamOutputEdgeCases — format details of operator<<
 // =============================================================================
@@ -1415,3 +1466,1892 @@ TEST(StreamOutputEdgeCases, ExponentOneNotPrinted) {
     oss << Length(1.0);
     EXPECT_EQ(oss.str().find("^1"), std::string::npos);
 }
+
+// =============================================================================
+// ECSResources — singleton storage and Resource<T> injection into view
+// =============================================================================
+
+TEST(ECSResources, DefaultConstructedOnFirstAccess) {
+    Registry reg;
+    EXPECT_FALSE(reg.has_resource<double>());
+    EXPECT_DOUBLE_EQ(reg.resource<double>(), 0.0);
+    EXPECT_TRUE(reg.has_resource<double>());
+}
+
+TEST(ECSResources, ResourceReferenceIsStable) {
+    Registry reg;
+    reg.set_resource<Acceleration>(-9.81);
+    double* addr = &reg.resource<Acceleration>().value;
+    reg.set_resource<Time>(0.01_s);                    // creating another resource must not move it
+    EXPECT_EQ(&reg.resource<Acceleration>().value, addr);
+    EXPECT_DOUBLE_EQ(reg.resource<Acceleration>().value, -9.81);
+}
+
+TEST(ECSResources, MissingNonDefaultConstructibleResourceThrows) {
+    Registry reg;
+    EXPECT_THROW(reg.resource<Temperature>(), std::out_of_range);
+    reg.set_resource<Temperature>(300.0_K);
+    EXPECT_DOUBLE_EQ(reg.resource<Temperature>().value, 300.0);
+}
+
+TEST(ECSResources, ResourceIsSeparateFromComponentPool) {
+    Registry reg;
+    reg.resource<int>() = 7;
+    reg.get_pool<int>().assign(0, 1);
+    EXPECT_EQ(reg.resource<int>(), 7);
+    EXPECT_EQ(reg.get_pool<int>().get(0), 1);
+}
+
+TEST(ECSResources, ViewInjectsResource) {
+    Registry reg;
+    reg.set_resource<Acceleration>(-10.0);
+    reg.set_resource<Time>(0.5_s);
+    for (int i = 0; i < 4; ++i) reg.get_pool<Velocity>().assign(i, Velocity(1.0));
+
+    reg.view<Velocity, Resource<Acceleration>, Resource<Time>>(
+        [](Velocity& v, Acceleration& g, Time& dt) { v = v + g * dt; });
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_DOUBLE_EQ(reg.get_pool<Velocity>().get(i).value, -4.0);
+}
+
+TEST(ECSResources, ResourceDoesNotFilterEntities) {
+    Registry reg;
+    for (int i = 0; i < 6; ++i) {
+        reg.get_pool<int>().assign(i, i);
+        if (i % 2 == 0) reg.get_pool<float>().assign(i, 1.0f);
+    }
+    int count = 0;
+    reg.view<int, Resource<double>, float>([&](int&, double&, float&) { count++; });
+    EXPECT_EQ(count, 3);
+}
+
+// =============================================================================
+// Hierarchy — breadth-first layout and linear parent-to-child propagation
+// =============================================================================
+
+TEST(Hierarchy, OrderIsBreadthFirstWithPackedSiblings) {
+    Hierarchy h;
+    h.attach(3, 0);
+    h.attach(1, 3);
+    h.attach(4, 0);
+    h.attach(2, 1);
+    h.attach(5, 3);
+    // 0 → {3, 4}; 3 → {1, 5}; 1 → {2}
+    EXPECT_EQ(h.order(), (std::vector<int>{0, 3, 4, 1, 5, 2}));
+    auto kids = h.children(3);
+    EXPECT_EQ(std::vector<int>(kids.begin(), kids.end()), (std::vector<int>{1, 5}));
+    EXPECT_TRUE(h.children(2).empty());
+    EXPECT_EQ(h.parent(1), 3);
+    EXPECT_EQ(h.parent(0), -1);
+}
+
+TEST(Hierarchy, CycleIsRejected) {
+    Hierarchy h;
+    h.attach(1, 0);
+    h.attach(2, 1);
+    EXPECT_THROW(h.attach(0, 2), std::invalid_argument);
+    EXPECT_THROW(h.attach(4, 4), std::invalid_argument);
+    EXPECT_EQ(h.order(), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(Hierarchy, DetachPromotesChildrenToRoots) {
+    Hierarchy h;
+    h.attach(1, 0);
+    h.attach(2, 1);
+    h.detach(1);
+    EXPECT_FALSE(h.contains(1));
+    EXPECT_EQ(h.parent(2), -1);
+    EXPECT_EQ(h.size(), 2u);
+    EXPECT_EQ(h.order(), (std::vector<int>{0, 2}));
+}
+
+TEST(Hierarchy, NonMembersAreOutOfRange) {
+    Hierarchy h;
+    h.attach(1, 0);
+    h.detach(0);
+    for (int e : {0, 5, -1}) {
+        EXPECT_FALSE(h.contains(e));
+        EXPECT_THROW(h.parent(e), std::out_of_range);
+        EXPECT_THROW(h.children(e), std::out_of_range);
+    }
+    EXPECT_TRUE(h.children(1).empty());
+}
+
+TEST(Hierarchy, SortPutsPoolInBreadthFirstOrder) {
+    ComponentPool<int> pool;
+    for (int e : {9, 2, 1, 0}) pool.assign(e, e * 10);
+    Hierarchy h;
+    h.attach(2, 0);
+    h.attach(1, 2);
+    h.sort(pool);
+    EXPECT_EQ(pool.entities(), (std::vector<int>{0, 2, 1, 9}));   // non-members trail
+    EXPECT_EQ(pool.get(9), 90);
+    EXPECT_EQ(pool.get(1), 10);
+    EXPECT_EQ(pool.components()[0], 0);
+}
+
+TEST(Hierarchy, SortRequiresEveryMemberInPool) {
+    ComponentPool<int> pool;
+    pool.assign(0, 0);
+    Hierarchy h;
+    h.attach(1, 0);
+    EXPECT_THROW(h.sort(pool), std::invalid_argument);
+}
+
+TEST(Hierarchy, PropagateLengthThroughThreeLevels) {
+    struct Transform { Length local; Length world; };
+    ComponentPool<Transform> pool;
+    pool.assign(2, {1.0_m, 0.0_m});   // grandchild
+    pool.assign(0, {10.0_m, 10.0_m}); // root: world == local
+    pool.assign(1, {2.0_m, 0.0_m});   // child
+    Hierarchy h;
+    h.attach(1, 0);
+    h.attach(2, 1);
+    h.propagate(pool, [](const Transform& parent, Transform& child) {
+        child.world = parent.world + child.local;
+    });
+    EXPECT_DOUBLE_EQ(pool.get(1).world.value, 12.0);
+    EXPECT_DOUBLE_EQ(pool.get(2).world.value, 13.0);
+}
+
+// =============================================================================
+// ECSSnapshot — Registry::snapshot / restore round trips
+// =============================================================================
+
+namespace {
+    struct Body { Mass m; Velocity v; };
+    struct Label { std::string name; };
+}
+
+TEST(ECSSnapshot, RoundTripRestoresAllPools) {
+    const std::string path = testing::TempDir() + "ecs_snapshot_roundtrip.bin";
+    {
+        Registry reg;
+        for (int i = 0; i < 100; ++i) {
+            reg.get_pool<Body>().assign(i, {Mass(i * 1.0), Velocity(-i * 2.0)});
+            if (i % 10 == 0) reg.get_pool<int>().assign(i, i * i);
+        }
+        reg.snapshot(path);
+    }
+    Registry restored;
+    restored.restore<Body, int>(path);
+    ASSERT_EQ(restored.get_pool<Body>().size(), 100u);
+    ASSERT_EQ(restored.get_pool<int>().size(), 10u);
+    EXPECT_DOUBLE_EQ(restored.get_pool<Body>().get(42).m.value, 42.0);
+    EXPECT_DOUBLE_EQ(restored.get_pool<Body>().get(42).v.value, -84.0);
+    EXPECT_EQ(restored.get_pool<int>().get(90), 8100);
+    EXPECT_FALSE(restored.get_pool<int>().contains(91));
+    EXPECT_TRUE(restored.get_pool<Body>().components().adopted());
+    const std::vector<int> ids = restored.get_pool<int>().entities();   // adopted, copied out as a vector
+    EXPECT_EQ(ids, (std::vector<int>{0, 10, 20, 30, 40, 50, 60, 70, 80, 90}));
+
+    int count = 0;
+    restored.view<int, Body>([&](int&, Body&) { count++; });
+    EXPECT_EQ(count, 10);
+}
+
+TEST(ECSSnapshot, RestoredPoolsAreMutableAndGrowable) {
+    const std::string path = testing::TempDir() + "ecs_snapshot_mutable.bin";
+    {
+        Registry reg;
+        reg.get_pool<int>().assign(0, 1);
+        reg.get_pool<int>().assign(1, 2);
+        reg.snapshot(path);
+    }
+    Registry reg;
+    reg.restore<int>(path);
+    reg.get_pool<int>().get(0) = 10;             // write into the private mapping
+    reg.get_pool<int>().assign(5, 50);           // growth copies into owned storage
+    EXPECT_FALSE(reg.get_pool<int>().components().adopted());
+    EXPECT_EQ(reg.get_pool<int>().get(0), 10);
+    EXPECT_EQ(reg.get_pool<int>().get(1), 2);
+    EXPECT_EQ(reg.get_pool<int>().get(5), 50);
+
+    Registry again;                              // the file itself is unchanged
+    again.restore<int>(path);
+    EXPECT_EQ(again.get_pool<int>().get(0), 1);
+}
+
+TEST(ECSSnapshot, RestoreClearsPoolsMissingFromFile) {
+    const std::string path = testing::TempDir() + "ecs_snapshot_clear.bin";
+    {
+        Registry reg;
+        reg.get_pool<int>().assign(0, 1);
+        reg.snapshot(path);
+    }
+    Registry reg;
+    reg.get_pool<float>().assign(3, 1.0f);
+    reg.restore<int>(path);
+    EXPECT_EQ(reg.get_pool<float>().size(), 0u);
+    EXPECT_FALSE(reg.get_pool<float>().contains(3));
+    EXPECT_EQ(reg.get_pool<int>().get(0), 1);
+}
+
+TEST(ECSSnapshot, NonTriviallyCopyableComponentIsRejected) {
+    Registry reg;
+    reg.get_pool<Label>().assign(0, {"probe"});
+    EXPECT_THROW(reg.snapshot(testing::TempDir() + "ecs_snapshot_label.bin"), std::logic_error);
+}
+
+TEST(ECSSnapshot, UnregisteredPoolAndBadFileAreRejected) {
+    const std::string path = testing::TempDir() + "ecs_snapshot_unregistered.bin";
+    {
+        Registry reg;
+        reg.get_pool<Body>().assign(0, {Mass(1.0), Velocity(1.0)});
+        reg.snapshot(path);
+    }
+    Registry reg;
+    EXPECT_THROW(reg.restore(path), std::runtime_error);   // no Body pool to adopt into
+
+    const std::string junk = testing::TempDir() + "ecs_snapshot_junk.bin";
+    std::ofstream(junk, std::ios::binary) << "not a snapshot at all";
+    EXPECT_THROW(reg.restore<Body>(junk), std::runtime_error);
+}
+
+TEST(ECSSnapshot, CorruptDirectoryAndIndicesAreRejected) {
+    const std::string path = testing::TempDir() + "ecs_snapshot_corrupt.bin";
+    {
+        Registry reg;
+        for (int i = 0; i < 4; ++i) reg.get_pool<int>().assign(i, i);
+        reg.snapshot(path);
+    }
+    std::string good;
+    {
+        std::ifstream in(path, std::ios::binary);
+        good.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    const size_t at = sizeof(detail::SnapshotHeader);
+    detail::SnapshotPoolEntry e;
+    std::memcpy(&e, good.data() + at, sizeof e);
+
+    // Write a copy of the file with one edit applied, and restore it
+    auto restore_with = [&](auto edit) {
+        std::string bytes = good;
+        edit(bytes);
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+        Registry reg;
+        reg.get_pool<int>().assign(7, 7);
+        reg.restore<int>(path);
+    };
+    auto set_entry = [&](detail::SnapshotPoolEntry patched) {
+        return [=](std::string& b) { std::memcpy(b.data() + at, &patched, sizeof patched); };
+    };
+    auto set_int = [](std::uint64_t offset, int v) {
+        return [=](std::string& b) { std::memcpy(b.data() + offset, &v, sizeof v); };
+    };
+
+    auto wrapped = e;                      // offset + count * 4 wraps to a small number
+    wrapped.dense_count = wrapped.entities_count = (~std::uint64_t(0)) / 4 + 1;
+    EXPECT_THROW(restore_with(set_entry(wrapped)), std::runtime_error);
+    auto mismatched = e;
+    mismatched.entities_count = e.dense_count - 1;
+    EXPECT_THROW(restore_with(set_entry(mismatched)), std::runtime_error);
+    auto realigned = e;                    // written by a build where int is 8-aligned
+    realigned.component_align = 8;
+    EXPECT_THROW(restore_with(set_entry(realigned)), std::runtime_error);
+    auto misplaced = e;                    // dense section off its alignment
+    misplaced.dense_offset += 1;
+    EXPECT_THROW(restore_with(set_entry(misplaced)), std::runtime_error);
+    EXPECT_THROW(restore_with(set_int(e.sparse_offset + sizeof(int), 4)), std::runtime_error);     // dense index past the end
+    EXPECT_THROW(restore_with(set_int(e.entities_offset + sizeof(int), -3)), std::runtime_error);  // negative entity
+    EXPECT_THROW(restore_with(set_int(e.entities_offset, 4)), std::runtime_error);                 // entity past sparse
+    EXPECT_NO_THROW(restore_with([](std::string&) {}));
+}
+
+// =============================================================================
+// Rollback — dirty-page ring buffer, rewind and resimulation
+// =============================================================================
+
+namespace {
+    struct Particle { Length x; Velocity v; };
+
+    void step(Registry& reg, Time dt) {
+        reg.view<Particle>([&](Particle& p) { p.x = p.x + p.v * dt; });
+    }
+}
+
+TEST(Rollback, RewindRestoresEarlierTick) {
+    Registry reg;
+    for (int i = 0; i < 1000; ++i) reg.get_pool<Particle>().assign(i, {Length(0.0), Velocity(i * 1.0)});
+    RollbackBuffer rb(reg, 8);
+    for (int tick = 0; tick < 5; ++tick) {
+        rb.capture();
+        step(reg, 1.0_s);
+    }
+    // Captures hold x = 0, 1, 2, 3, 4 × v; current state is 5 × v
+    rb.rewind(2);
+    EXPECT_EQ(rb.size(), 3u);
+    EXPECT_DOUBLE_EQ(reg.get_pool<Particle>().get(10).x.value, 20.0);
+    EXPECT_DOUBLE_EQ(reg.get_pool<Particle>().get(999).x.value, 2.0 * 999.0);
+}
+
+TEST(Rollback, ResimulationIsDeterministic) {
+    Registry reg;
+    for (int i = 0; i < 100; ++i) reg.get_pool<Particle>().assign(i, {Length(i * 1.0), Velocity(0.5)});
+    RollbackBuffer rb(reg, 4);
+    rb.capture();
+    for (int t = 0; t < 3; ++t) step(reg, 0.1_s);
+    const double expected = reg.get_pool<Particle>().get(50).x.value;
+
+    rb.rewind(0);                                  // discard everything since the capture
+    EXPECT_DOUBLE_EQ(reg.get_pool<Particle>().get(50).x.value, 50.0);
+    for (int t = 0; t < 3; ++t) step(reg, 0.1_s);
+    EXPECT_DOUBLE_EQ(reg.get_pool<Particle>().get(50).x.value, expected);
+}
+
+TEST(Rollback, OnlyDirtyPagesAreStored) {
+    Registry reg;
+    for (int i = 0; i < 100000; ++i) reg.get_pool<Particle>().assign(i, {Length(0.0), Velocity(0.0)});
+    RollbackBuffer rb(reg, 16);
+    rb.capture();
+    const size_t baseline = rb.baseline_bytes();
+    EXPECT_GE(baseline, 100000u * sizeof(Particle));
+    EXPECT_EQ(rb.delta_bytes(), 0u);
+
+    reg.get_pool<Particle>().get(12345).x = 1.0_m;  // one component → one dirty page
+    rb.capture();
+    EXPECT_GT(rb.delta_bytes(), 0u);
+    EXPECT_LE(rb.delta_bytes(), 4096u + 64u);
+    EXPECT_EQ(rb.memory_usage(), rb.baseline_bytes() + rb.delta_bytes());
+
+    rb.rewind(1);
+    EXPECT_DOUBLE_EQ(reg.get_pool<Particle>().get(12345).x.value, 0.0);
+}
+
+TEST(Rollback, PoolGrowthAndNewPoolsAreUndone) {
+    Registry reg;
+    reg.get_pool<int>().assign(0, 1);
+    RollbackBuffer rb(reg, 4);
+    rb.capture();
+    reg.get_pool<int>().assign(7000, 2);            // grows sparse across several pages
+    reg.get_pool<float>().assign(1, 3.0f);          // pool that did not exist at the capture
+    rb.capture();
+    rb.rewind(1);
+    EXPECT_EQ(reg.get_pool<int>().size(), 1u);
+    EXPECT_FALSE(reg.get_pool<int>().contains(7000));
+    EXPECT_EQ(reg.get_pool<int>().get(0), 1);
+    EXPECT_EQ(reg.get_pool<float>().size(), 0u);
+}
+
+TEST(Rollback, RingDropsOldestAndLimitsRewind) {
+    Registry reg;
+    reg.get_pool<int>().assign(0, 0);
+    RollbackBuffer rb(reg, 3);
+    for (int tick = 1; tick <= 5; ++tick) {
+        rb.capture();
+        reg.get_pool<int>().get(0) = tick;
+    }
+    // Captures of values 0..4 were taken; only the last three (2, 3, 4) remain
+    EXPECT_EQ(rb.size(), 3u);
+    EXPECT_THROW(rb.rewind(3), std::out_of_range);
+    rb.rewind(2);
+    EXPECT_EQ(reg.get_pool<int>().get(0), 2);
+}
+
+// =============================================================================
+// Replication — DeltaEncoder / apply_delta round trips
+// =============================================================================
+
+namespace {
+    template <typename T>
+    void expect_pools_equal(const ComponentPool<T>& a, const ComponentPool<T>& b) {
+        ASSERT_EQ(a.size(), b.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            EXPECT_EQ(a.entities()[i], b.entities()[i]);
+            EXPECT_EQ(std::memcmp(&a.components()[i], &b.components()[i], sizeof(T)), 0);
+        }
+    }
+}
+
+TEST(Replication, FirstMessageCarriesWholePool) {
+    ComponentPool<Particle> src, mirror;
+    for (int i = 0; i < 500; ++i) src.assign(i * 3, {Length(i * 0.25), Velocity(-1.5 * i)});
+    DeltaEncoder<Particle> enc;
+    std::vector<std::byte> msg;
+    const size_t bytes = enc.encode(src, msg);
+    EXPECT_EQ(bytes, msg.size());
+    EXPECT_EQ(apply_delta(mirror, msg), msg.size());
+    expect_pools_equal(src, mirror);
+    EXPECT_DOUBLE_EQ(mirror.get(300).x.value, 25.0);
+}
+
+TEST(Replication, UnchangedTickIsHeaderOnly) {
+    ComponentPool<Particle> src, mirror;
+    for (int i = 0; i < 1000; ++i) src.assign(i, {Length(i * 1.0), Velocity(1.0)});
+    DeltaEncoder<Particle> enc;
+    std::vector<std::byte> msg;
+    enc.encode(src, msg);
+    apply_delta(mirror, msg);
+
+    msg.clear();
+    enc.encode(src, msg);
+    EXPECT_LE(msg.size(), 48u);
+    apply_delta(mirror, msg);
+    expect_pools_equal(src, mirror);
+}
+
+TEST(Replication, SparseChangesCompressWell) {
+    ComponentPool<Particle> src, mirror;
+    for (int i = 0; i < 10000; ++i) src.assign(i, {Length(i * 1.0), Velocity(2.0)});
+    DeltaEncoder<Particle> enc;
+    std::vector<std::byte> msg;
+    enc.encode(src, msg);
+    apply_delta(mirror, msg);
+
+    for (int tick = 0; tick < 5; ++tick) {
+        for (int i = tick; i < 10000; i += 100)           // 1% of particles move
+            src.get(i).x = src.get(i).x + src.get(i).v * 0.016_s;
+        msg.clear();
+        enc.encode(src, msg);
+        EXPECT_LT(msg.size(), 100u * sizeof(Particle));  // far below resending moved components raw
+        apply_delta(mirror, msg);
+        expect_pools_equal(src, mirror);
+    }
+}
+
+TEST(Replication, GrowthReorderAndTruncation) {
+    ComponentPool<Particle> src, mirror;
+    for (int i = 0; i < 10; ++i) src.assign(i, {Length(i * 1.0), Velocity(0.0)});
+    DeltaEncoder<Particle> enc;
+    std::vector<std::byte> stream;
+    enc.encode(src, stream);
+
+    src.assign(42, {Length(42.0), Velocity(4.2)});         // growth
+    enc.encode(src, stream);
+    src.reorder({9, 42, 0});                              // slots change entity
+    enc.encode(src, stream);
+    src.truncate(5);                                      // shrink
+    enc.encode(src, stream);
+
+    // Messages are self-delimiting: replay the concatenated stream
+    for (size_t at = 0; at < stream.size();)
+        at += apply_delta(mirror, std::span<const std::byte>(stream).subspan(at));
+    expect_pools_equal(src, mirror);
+    EXPECT_TRUE(mirror.contains(42));
+    EXPECT_DOUBLE_EQ(mirror.get(42).v.value, 4.2);
+    EXPECT_FALSE(mirror.contains(7));
+}
+
+TEST(Replication, MismatchedMessageIsRejected) {
+    ComponentPool<Particle> src;
+    src.assign(0, {Length(1.0), Velocity(1.0)});
+    DeltaEncoder<Particle> enc;
+    std::vector<std::byte> msg;
+    enc.encode(src, msg);
+
+    ComponentPool<int> wrong_type;
+    EXPECT_THROW(apply_delta(wrong_type, msg), std::runtime_error);
+    ComponentPool<Particle> mirror;
+    msg.resize(msg.size() - 1);
+    EXPECT_THROW(apply_delta(mirror, msg), std::runtime_error);
+}
+
+TEST(Replication, ForgedPayloadSizeIsRejected) {
+    ComponentPool<Particle> src;
+    src.assign(0, {Length(1.0), Velocity(1.0)});
+    DeltaEncoder<Particle> enc;
+    std::vector<std::byte> msg;
+    enc.encode(src, msg);
+
+    // A payload size that wraps `sizeof header + payload_bytes` round to a
+    // small number must not pass the length check
+    detail::DeltaHeader h;
+    std::memcpy(&h, msg.data(), sizeof h);
+    h.payload_bytes = ~std::uint64_t(0) - (sizeof h - 1);
+    std::memcpy(msg.data(), &h, sizeof h);
+    ComponentPool<Particle> mirror;
+    EXPECT_THROW(apply_delta(mirror, msg), std::runtime_error);
+    EXPECT_THROW(delta_message_size(msg.data()), std::runtime_error);
+    EXPECT_EQ(mirror.size(), 0u);
+
+    std::vector<std::byte> header_only(msg.begin(), msg.begin() + sizeof h - 1);
+    EXPECT_THROW(apply_delta(mirror, header_only), std::runtime_error);
+}
+
+TEST(Replication, MalformedMessageLeavesMirrorUntouched) {
+    ComponentPool<Particle> src, mirror, before;
+    for (int i = 0; i < 10; ++i) src.assign(i, {Length(i * 1.0), Velocity(0.5)});
+    DeltaEncoder<Particle> enc;
+    std::vector<std::byte> msg;
+    enc.encode(src, msg);
+    apply_delta(mirror, msg);
+    apply_delta(before, msg);
+
+    // Shrink and patch in one message, then damage it in two ways
+    src.truncate(4);
+    src.get(1).x = Length(-7.0);
+    src.assign(99, {Length(9.9), Velocity(9.9)});
+    msg.clear();
+    enc.encode(src, msg);
+    detail::DeltaHeader h;
+    std::memcpy(&h, msg.data(), sizeof h);
+
+    auto cut = msg;                                   // payload ends mid-slot
+    detail::DeltaHeader short_h = h;
+    short_h.payload_bytes -= 2;
+    std::memcpy(cut.data(), &short_h, sizeof h);
+    cut.resize(cut.size() - 2);
+    EXPECT_THROW(apply_delta(mirror, cut), std::runtime_error);
+    expect_pools_equal(before, mirror);
+
+    auto grown = msg;                                 // claims a slot it never sends
+    detail::DeltaHeader long_h = h;
+    long_h.slot_count = before.size() + 1;
+    std::memcpy(grown.data(), &long_h, sizeof h);
+    EXPECT_THROW(apply_delta(mirror, grown), std::runtime_error);
+    expect_pools_equal(before, mirror);
+
+    apply_delta(mirror, msg);
+    expect_pools_equal(src, mirror);
+}
+
+// =============================================================================
+// QuantityRep — Quantity<Dim, Rep> storage types and mixed-rep promotion
+// =============================================================================
+
+namespace {
+    using LengthF = RebindRep<Length, float>;
+    using TimeF   = RebindRep<Time, float>;
+    using LengthI = RebindRep<Length, std::int64_t>;
+    using Fixed16 = FixedPoint<16>;
+}
+
+TEST(QuantityRep, DefaultRepIsDouble) {
+    static_assert(std::is_same_v<Length, Quantity<Length::DimensionType, double>>);
+    static_assert(std::is_same_v<Length::RepType, double>);
+    static_assert(IsQuantity<LengthF> && IsQuantity<LengthI>);
+    static_assert(sizeof(LengthF) == sizeof(float));
+    static_assert(sizeof(RebindRep<Length, Fixed16>) == sizeof(std::int64_t));
+}
+
+TEST(QuantityRep, SameRepArithmeticStaysInRep) {
+    LengthF a(1.5f), b(2.0f);
+    auto sum  = a + b;
+    auto area = a * b;
+    static_assert(std::is_same_v<decltype(sum), LengthF>);
+    static_assert(std::is_same_v<decltype(area), RebindRep<Area, float>>);
+    EXPECT_FLOAT_EQ(sum.value, 3.5f);
+    EXPECT_FLOAT_EQ(area.value, 3.0f);
+    EXPECT_FLOAT_EQ((a * 2.0f).value, 3.0f);
+}
+
+TEST(QuantityRep, MixedRepsPromoteToCommonType) {
+    LengthF x(3.0f);
+    Time    t(2.0);
+    auto v = x / t;
+    static_assert(std::is_same_v<decltype(v), Velocity>);
+    EXPECT_DOUBLE_EQ(v.value, 1.5);
+
+    auto d = LengthI(7) + Length(0.5);
+    static_assert(std::is_same_v<decltype(d), Length>);
+    EXPECT_DOUBLE_EQ(d.value, 7.5);
+
+    auto f = LengthI(4) * TimeF(0.5f);
+    static_assert(std::is_same_v<decltype(f)::RepType, float>);
+    EXPECT_FLOAT_EQ(f.value, 2.0f);
+}
+
+TEST(QuantityRep, IntegerRepUsesIntegerArithmetic) {
+    LengthI a(7), b(2);
+    EXPECT_EQ((a / b).value, 3);
+    EXPECT_EQ((a - b).value, 5);
+    EXPECT_EQ((-a).value, -7);
+    EXPECT_TRUE(b < a);
+}
+
+TEST(QuantityRep, ScalarsPromoteLikeQuantities) {
+    auto half = LengthI(7) * 0.5;
+    static_assert(std::is_same_v<decltype(half), Length>);
+    EXPECT_DOUBLE_EQ(half.value, 3.5);
+    EXPECT_DOUBLE_EQ((0.5 * LengthI(7)).value, 3.5);
+    EXPECT_DOUBLE_EQ((LengthI(7) / 2.0).value, 3.5);
+
+    auto twice = LengthI(7) * 2;                  // int64 * int stays int64
+    static_assert(std::is_same_v<decltype(twice), LengthI>);
+    EXPECT_EQ(twice.value, 14);
+    static_assert(std::is_same_v<decltype(LengthF(1.0f) * 2.0), Length>);
+    static_assert(std::is_same_v<decltype(LengthF(1.0f) * 2), LengthF>);
+    EXPECT_DOUBLE_EQ((Length(1.5) * 2).value, 3.0);
+
+    using LengthX = RebindRep<Length, Fixed16>;   // FixedPoint's own common_type rules
+    static_assert(std::is_same_v<decltype(LengthX(Fixed16(1.0)) * 0.5), Length>);
+    static_assert(std::is_same_v<decltype(LengthX(Fixed16(1.0)) * 3), LengthX>);
+}
+
+TEST(QuantityRep, ConversionIsExplicit) {
+    static_assert(!std::is_convertible_v<Length, LengthF>);
+    static_assert(std::is_constructible_v<LengthF, Length>);
+    LengthF f(Length(0.25));
+    EXPECT_FLOAT_EQ(f.value, 0.25f);
+    auto i = quantity_cast<std::int64_t>(Length(9.75));
+    static_assert(std::is_same_v<decltype(i), LengthI>);
+    EXPECT_EQ(i.value, 9);
+}
+
+TEST(QuantityRep, MathFunctionsPreserveRep) {
+    auto a = pow<2>(LengthF(3.0f));
+    static_assert(std::is_same_v<decltype(a), RebindRep<Area, float>>);
+    EXPECT_FLOAT_EQ(a.value, 9.0f);
+    auto l = sqrt(a);
+    static_assert(std::is_same_v<decltype(l), LengthF>);
+    EXPECT_FLOAT_EQ(l.value, 3.0f);
+    EXPECT_FLOAT_EQ(abs(LengthF(-2.0f)).value, 2.0f);
+}
+
+TEST(QuantityRep, FixedPointRep) {
+    using LengthX = RebindRep<Length, Fixed16>;
+    LengthX a(Fixed16(1.25)), b(Fixed16(0.5));
+    EXPECT_EQ((a + b).value, Fixed16(1.75));
+    EXPECT_EQ((a * b).value, Fixed16(0.625));
+    EXPECT_EQ((a / b).value, Fixed16(2.5));
+    EXPECT_EQ((a * 4).value.raw, 5 * Fixed16::one);
+    EXPECT_EQ(abs(-a), a);
+    EXPECT_DOUBLE_EQ(static_cast<double>(sqrt(a * a).value), 1.25);
+
+    // Mixing with double computes in double
+    auto d = a + Length(0.125);
+    static_assert(std::is_same_v<decltype(d), Length>);
+    EXPECT_DOUBLE_EQ(d.value, 1.375);
+
+    std::ostringstream os;
+    os << a;
+    EXPECT_EQ(os.str().substr(0, 4), "1.25");
+}
+
+// =============================================================================
+// QuantityPack — SIMD lanes with the Quantity dimension algebra
+// =============================================================================
+
+namespace {
+    using LengthPack = QuantityPack<Length::DimensionType, 4>;
+    using TimePack   = QuantityPack<Time::DimensionType, 4>;
+    using MassPack   = QuantityPack<Mass::DimensionType, 4>;
+
+    template <typename A, typename B>
+    concept Addable = requires(A a, B b) { a + b; };
+    template <typename A, typename B>
+    concept Subtractable = requires(A a, B b) { a - b; };
+
+    template <typename Dim, int N, typename T>
+    void expect_lanes(const QuantityPack<Dim, N, T>& q, std::initializer_list<double> want) {
+        int i = 0;
+        for (double w : want) EXPECT_DOUBLE_EQ(static_cast<double>(q.value[i++]), w);
+    }
+}
+
+TEST(QuantityPack, DimensionAlgebraMatchesQuantity) {
+    static_assert(IsQuantity<LengthPack>);
+    static_assert(sizeof(LengthPack) == 4 * sizeof(double));
+    LengthPack x(1.0_m);
+    TimePack   t(2.0_s);
+    MassPack   m(3.0_kg);
+    static_assert(std::is_same_v<decltype(x / t), QuantityPack<Velocity::DimensionType, 4>>);
+    static_assert(std::is_same_v<decltype(m * x / (t * t)), QuantityPack<Force::DimensionType, 4>>);
+    expect_lanes(m * x / (t * t), {0.75, 0.75, 0.75, 0.75});
+    static_assert(Addable<LengthPack, LengthPack> && !Addable<LengthPack, TimePack>);
+    static_assert(!Subtractable<LengthPack, MassPack>);
+}
+
+TEST(QuantityPack, LaneWiseArithmetic) {
+    const Length xs[4] = {1.0_m, 2.0_m, 3.0_m, 4.0_m};
+    const Time   ts[4] = {1.0_s, 4.0_s, 0.5_s, 2.0_s};
+    auto x = load_pack<4>(xs);
+    auto t = load_pack<4>(ts);
+    expect_lanes(x / t, {1.0, 0.5, 6.0, 2.0});
+    expect_lanes(x + x, {2.0, 4.0, 6.0, 8.0});
+    expect_lanes(-x * 2.0, {-2.0, -4.0, -6.0, -8.0});
+    EXPECT_EQ(lane(x * t, 2), 1.5_m * 1.0_s);
+}
+
+TEST(QuantityPack, ScalarQuantityBroadcasts) {
+    const Velocity vs[4] = {Velocity(1.0), Velocity(2.0), Velocity(3.0), Velocity(4.0)};
+    auto v = load_pack<4>(vs);
+    auto d = v * 2.0_s + 1.0_m;
+    static_assert(std::is_same_v<decltype(d), LengthPack>);
+    expect_lanes(d, {3.0, 5.0, 7.0, 9.0});
+    expect_lanes(LengthPack(3.0_m), {3.0, 3.0, 3.0, 3.0});
+}
+
+TEST(QuantityPack, MathFunctions) {
+    const Length xs[4] = {-3.0_m, 4.0_m, 0.5_m, 2.0_m};
+    auto x = load_pack<4>(xs);
+    auto a = pow<2>(x);
+    static_assert(std::is_same_v<decltype(a), QuantityPack<Area::DimensionType, 4>>);
+    expect_lanes(a, {9.0, 16.0, 0.25, 4.0});
+    expect_lanes(sqrt(a), {3.0, 4.0, 0.5, 2.0});
+    expect_lanes(abs(x), {3.0, 4.0, 0.5, 2.0});
+    auto inv = pow<-1>(x);
+    static_assert(std::is_same_v<decltype(inv)::DimensionType, Dimensions<0, -1, 0>>);
+    expect_lanes(inv, {-1.0 / 3, 0.25, 2.0, 0.5});
+}
+
+TEST(QuantityPack, LoadStoreAndReduce) {
+    std::vector<Length> in, out(16, 0.0_m);
+    for (int i = 0; i < 16; ++i) in.push_back(Length(i * 1.0));
+    Length total(0.0);
+    for (int i = 0; i < 16; i += 4) {
+        auto p = load_pack<4>(&in[i]) * 2.0;
+        store_pack(p, &out[i]);
+        total = total + reduce_add(p);
+    }
+    for (int i = 0; i < 16; ++i) EXPECT_DOUBLE_EQ(out[i].value, 2.0 * i);
+    EXPECT_DOUBLE_EQ(total.value, 240.0);
+}
+
+TEST(QuantityPack, FloatLanes) {
+    using LengthF8 = QuantityPack<Length::DimensionType, 8, float>;
+    static_assert(sizeof(LengthF8) == 8 * sizeof(float));
+    float raw[8] = {1, 4, 9, 16, 25, 36, 49, 64};
+    auto a = QuantityPack<Area::DimensionType, 8, float>(simd::Pack<float, 8>::load(raw));
+    LengthF8 r = sqrt(a);
+    expect_lanes(r, {1, 2, 3, 4, 5, 6, 7, 8});
+}
+
+// =============================================================================
+// QuantityVector — aligned columns with element-wise dimensioned kernels
+// =============================================================================
+
+namespace {
+    // Sizes straddle the pack width so both the vector body and scalar tail run
+    QuantityVector<Length::DimensionType> lengths(size_t n) {
+        QuantityVector<Length::DimensionType> v;
+        for (size_t i = 0; i < n; ++i) v.push_back(Length(1.0 + i));
+        return v;
+    }
+}
+
+TEST(QuantityVector, StorageIsAlignedAndContiguous) {
+    QuantityVector<Mass::DimensionType> m(37, 2.0_kg);
+    EXPECT_EQ(m.size(), 37u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(m.data()) % 64, 0u);
+    EXPECT_EQ(m[36], 2.0_kg);
+    EXPECT_EQ(m.span().size(), 37u);
+    m.push_back(3.0_kg);
+    EXPECT_EQ(m.end() - m.begin(), 38);
+}
+
+TEST(QuantityVector, SpansViewRawStorageWithoutCopying) {
+    std::vector<double> raw{1.0, 2.0, 3.0};
+    auto x = as_quantities<Length::DimensionType>(std::span(raw));
+    static_assert(std::is_same_v<decltype(x), std::span<Length>>);
+    EXPECT_EQ(static_cast<void*>(x.data()), static_cast<void*>(raw.data()));
+    EXPECT_EQ(x[2], 3.0_m);
+    x[0] = 5.0_m;
+    EXPECT_EQ(raw[0], 5.0);
+
+    const std::array<float, 4> fixed{1, 2, 3, 4};
+    auto t = as_quantities<Time::DimensionType>(std::span(fixed));
+    static_assert(std::is_same_v<decltype(t), std::span<const RebindRep<Time, float>, 4>>);
+    EXPECT_EQ(t[3].value, 4.0f);
+
+    auto v = lengths(5);
+    auto d = as_doubles(v.span());
+    static_assert(std::is_same_v<decltype(d), std::span<double>>);
+    EXPECT_EQ(d.size(), 5u);
+    EXPECT_EQ(d[4], 5.0);
+    static_assert(std::is_same_v<decltype(as_doubles(std::as_const(v).span())), std::span<const double>>);
+    EXPECT_EQ(as_quantities<Length::DimensionType>(d).data(), v.data());
+}
+
+TEST(QuantityVector, OnlyTrivialStorageIsLeftUninitialised) {
+    using LengthX = RebindRep<Length, Fixed16>;
+    static_assert(detail::trivial_storage_v<Length> && detail::trivial_storage_v<double>);
+    static_assert(!detail::trivial_storage_v<LengthX> && !detail::trivial_storage_v<std::string>);
+
+    alignas(LengthX) unsigned char raw[sizeof(LengthX)];
+    std::memset(raw, 0xAB, sizeof raw);
+    auto* x = reinterpret_cast<LengthX*>(raw);
+    detail::AlignedAllocator<LengthX>{}.construct(x);
+    EXPECT_EQ(x->value, Fixed16(0));
+
+    QuantityVector<Length::DimensionType, Fixed16> v(QuantityVector<Length::DimensionType, Fixed16>::uninitialized_t{}, 3);
+    for (const auto& q : v) EXPECT_EQ(q.value, Fixed16(0));
+    std::vector<std::string, detail::AlignedAllocator<std::string>> names(2);
+    EXPECT_TRUE(names[0].empty() && names[1].empty());
+}
+
+TEST(QuantityVector, ElementWiseDimensions) {
+    auto x = lengths(13);
+    QuantityVector<Time::DimensionType> t(13, 2.0_s);
+    QuantityVector v = x / t;
+    static_assert(std::is_same_v<decltype(v), QuantityVector<Velocity::DimensionType>>);
+    auto a = eval(x * x);
+    static_assert(std::is_same_v<decltype(a)::value_type, Area>);
+    for (size_t i = 0; i < 13; ++i) {
+        EXPECT_DOUBLE_EQ(v[i].value, (1.0 + i) / 2.0);
+        EXPECT_DOUBLE_EQ(a[i].value, (1.0 + i) * (1.0 + i));
+    }
+    static_assert(!Addable<QuantityVector<Length::DimensionType>, QuantityVector<Time::DimensionType>>);
+    static_assert(Addable<QuantityVector<Length::DimensionType>, QuantityVector<Length::DimensionType>>);
+}
+
+TEST(QuantityVector, ScalarsAndScalarQuantitiesBroadcast) {
+    auto x = lengths(9);
+    auto y = 2.0 * x - 1.0_m;
+    auto v = x / 4.0_s;
+    static_assert(std::is_same_v<decltype(v)::value_type, Velocity>);
+    for (size_t i = 0; i < 9; ++i) {
+        EXPECT_DOUBLE_EQ(y[i].value, 2.0 * (1.0 + i) - 1.0);
+        EXPECT_DOUBLE_EQ(v[i].value, (1.0 + i) / 4.0);
+        EXPECT_DOUBLE_EQ((-x)[i].value, -(1.0 + i));
+    }
+}
+
+TEST(QuantityVector, MathFunctions) {
+    auto x = lengths(11);
+    QuantityVector area = pow<2>(x);
+    QuantityVector back = sqrt(area);
+    static_assert(std::is_same_v<decltype(back), QuantityVector<Length::DimensionType>>);
+    auto inv = pow<-1>(x);
+    static_assert(std::is_same_v<decltype(inv)::DimensionType, Dimensions<0, -1, 0>>);
+    auto neg = abs(-1.0 * x);
+    for (size_t i = 0; i < 11; ++i) {
+        EXPECT_DOUBLE_EQ(back[i].value, 1.0 + i);
+        EXPECT_DOUBLE_EQ(inv[i].value, 1.0 / (1.0 + i));
+        EXPECT_DOUBLE_EQ(neg[i].value, 1.0 + i);
+    }
+}
+
+TEST(QuantityVector, MixedRepsFallBackToScalarLoop) {
+    QuantityVector<Length::DimensionType, float> xf(10, LengthF(1.5f));
+    auto sum = xf + lengths(10);
+    static_assert(std::is_same_v<decltype(sum)::RepType, double>);
+    EXPECT_DOUBLE_EQ(sum[9].value, 11.5);
+    auto half = xf * 0.5;                     // float * double, as for scalars
+    static_assert(std::is_same_v<decltype(half)::RepType, double>);
+    EXPECT_DOUBLE_EQ(half[3].value, 0.75);
+    auto halff = xf * 0.5f;
+    static_assert(std::is_same_v<decltype(halff)::RepType, float>);
+    static_assert(decltype(halff)::vectorizable);
+    EXPECT_FLOAT_EQ(halff[3].value, 0.75f);
+}
+
+TEST(QuantityVector, SizeMismatchThrows) {
+    EXPECT_THROW(lengths(4) + lengths(5), std::invalid_argument);
+    EXPECT_TRUE((lengths(0) * lengths(0)).empty());
+}
+
+// =============================================================================
+// ExpressionTemplates — lazy QuantityExpr trees evaluated in one pass
+// =============================================================================
+
+namespace {
+    // Counts how many evaluations touch an element, to prove fusion
+    struct Probe {
+        static inline int calls = 0;
+        template <typename X>
+        auto operator()(const X& x) const {
+            ++calls;
+            return x;
+        }
+    };
+}
+
+TEST(ExpressionTemplates, OperatorsBuildTypedExpressions) {
+    QuantityVector<Mass::DimensionType>     m(10, 2.0_kg);
+    QuantityVector<Velocity::DimensionType> v(10, Velocity(3.0));
+    auto e = 0.5 * m * pow<2>(v);
+    static_assert(is_quantity_expr_v<decltype(e)>);
+    static_assert(std::is_same_v<decltype(e)::value_type, Energy>);
+    EXPECT_EQ(e.size(), 10u);
+    EXPECT_DOUBLE_EQ(e[4].value, 9.0);   // elements are computable on demand
+    static_assert(!Addable<decltype(e), QuantityVector<Mass::DimensionType>>);
+}
+
+TEST(ExpressionTemplates, AssignmentEvaluatesEachElementOnce) {
+    QuantityVector<Length::DimensionType> x = lengths(21);
+    auto probed = detail::make_expr<Probe>(x);
+    Probe::calls = 0;
+    QuantityVector<Area::DimensionType> r = probed * probed + x * x - x * probed;
+    // one call per element for each of the three probe nodes, scalar or pack
+    EXPECT_LE(Probe::calls, 3 * 21);
+    for (size_t i = 0; i < 21; ++i) EXPECT_DOUBLE_EQ(r[i].value, (1.0 + i) * (1.0 + i));
+}
+
+TEST(ExpressionTemplates, KineticEnergyMatchesScalarFormula) {
+    QuantityVector<Mass::DimensionType>     m;
+    QuantityVector<Velocity::DimensionType> v;
+    for (int i = 0; i < 37; ++i) {
+        m.push_back(Mass(1.0 + i));
+        v.push_back(Velocity(0.5 * i));
+    }
+    QuantityVector<Energy::DimensionType> ke = 0.5 * m * pow<2>(v);
+    const Acceleration g(9.81);
+    QuantityVector<Length::DimensionType> h  = ke / (m * g);
+    for (int i = 0; i < 37; ++i) {
+        EXPECT_DOUBLE_EQ(ke[i].value, 0.5 * (1.0 + i) * (0.5 * i) * (0.5 * i));
+        EXPECT_NEAR(h[i].value, (0.5 * i) * (0.5 * i) / (2 * 9.81), 1e-12);
+    }
+}
+
+TEST(ExpressionTemplates, InPlaceUpdateAndTemporaries) {
+    QuantityVector<Length::DimensionType> x = lengths(9);
+    QuantityVector<Velocity::DimensionType> v(9, Velocity(2.0));
+    x = x + v * 0.5_s;                         // reads and writes x in one pass
+    EXPECT_DOUBLE_EQ(x[8].value, 10.0);
+
+    auto e = lengths(9) * 2.0;                 // the temporary vector is owned by e
+    EXPECT_DOUBLE_EQ(e[8].value, 18.0);
+    EXPECT_THROW(x + lengths(3), std::invalid_argument);
+}
+
+TEST(ExpressionTemplates, RepChangeIsExplicit) {
+    QuantityVector<Length::DimensionType> x = lengths(5);
+    static_assert(!std::is_convertible_v<decltype(x * 2.0), QuantityVector<Length::DimensionType, float>>);
+    QuantityVector<Length::DimensionType, float> xf(x * 2.0);
+    EXPECT_FLOAT_EQ(xf[4].value, 10.0f);
+}
+
+// =============================================================================
+// FusedMath — fma, hypot, lerp and midpoint on quantities
+// =============================================================================
+
+namespace {
+    template <typename A, typename B, typename C>
+    concept Fmaable = requires(A a, B b, C c) { fma(a, b, c); };
+}
+
+TEST(FusedMath, FmaChecksProductDimension) {
+    Length x = fma(Velocity(2.0), 0.5_s, 1.0_m);
+    EXPECT_DOUBLE_EQ(x.value, 2.0);
+    static_assert(Fmaable<Velocity, Time, Length>);
+    static_assert(!Fmaable<Velocity, Time, Time>);
+    static_assert(!Fmaable<Velocity, Length, Length>);
+    constexpr Energy e = fma(2.0_N, 3.0_m, 1.0_J);
+    static_assert(e.value == 7.0);
+}
+
+TEST(FusedMath, FmaRoundsOnceWithHardwareSupport) {
+    // (1 + 2^-30)^2 - (1 + 2^-29) = 2^-60, lost entirely by a separate multiply
+    const double a = 1.0 + std::ldexp(1.0, -30);
+    const double c = -(1.0 + std::ldexp(1.0, -29));
+    const Area r = fma(Length(a), Length(a), Area(c));
+    if constexpr (detail::kFastFma) EXPECT_EQ(r.value, std::ldexp(1.0, -60));
+    else                            EXPECT_NEAR(r.value, 0.0, 1e-15);
+}
+
+TEST(FusedMath, FmaPromotesMixedReps) {
+    auto x = fma(RebindRep<Velocity, float>(1.5f), 2.0_s, RebindRep<Length, float>(1.0f));
+    static_assert(std::is_same_v<decltype(x), Length>);
+    EXPECT_DOUBLE_EQ(x.value, 4.0);
+}
+
+TEST(FusedMath, HypotIsSafeAcrossRange) {
+    EXPECT_DOUBLE_EQ(hypot(3.0_m, 4.0_m).value, 5.0);
+    EXPECT_DOUBLE_EQ(hypot(Length(3e200), Length(4e200)).value, 5e200);
+    EXPECT_DOUBLE_EQ(hypot(Length(3e-200), Length(4e-200)).value, 5e-200);
+    EXPECT_FLOAT_EQ(hypot(RebindRep<Length, float>(3e30f), RebindRep<Length, float>(4e30f)).value, 5e30f);
+    static_assert(std::is_same_v<decltype(hypot(1.0_N, 1.0_N)), Force>);
+}
+
+TEST(FusedMath, LerpIsExactAtEndpoints) {
+    const Temperature a(0.1), b(273.15);
+    EXPECT_EQ(lerp(a, b, 0.0), a);
+    EXPECT_EQ(lerp(a, b, 1.0), b);
+    EXPECT_DOUBLE_EQ(lerp(10.0_m, 20.0_m, 0.25).value, 12.5);
+    EXPECT_DOUBLE_EQ(lerp(10.0_m, 20.0_m, 2).value, 30.0);
+
+    // b - a overflows here; the endpoints and the middle must not
+    const double big = std::numeric_limits<double>::max();
+    EXPECT_EQ(lerp(Length(-big), Length(big), 0.0), Length(-big));
+    EXPECT_EQ(lerp(Length(-big), Length(big), 1.0), Length(big));
+    EXPECT_EQ(lerp(Length(-big), Length(big), 0.5), Length(0.0));
+    EXPECT_DOUBLE_EQ(lerp(-2.0_m, 6.0_m, 0.25).value, 0.0);
+}
+
+TEST(FusedMath, MidpointAvoidsOverflow) {
+    const double big = std::numeric_limits<double>::max();
+    EXPECT_DOUBLE_EQ(midpoint(Length(big), Length(big)).value, big);
+    EXPECT_DOUBLE_EQ(midpoint(-2.0_J, 6.0_J).value, 2.0);
+    static_assert(midpoint(1.0_s, 3.0_s).value == 2.0);
+    EXPECT_EQ(midpoint(RebindRep<Length, std::int64_t>(1), RebindRep<Length, std::int64_t>(4)).value, 2);
+}
+
+// =============================================================================
+// RationalExponents — fractional dimensions, pow<P, Q>, sqrt and cbrt on any dimension
+// =============================================================================
+
+TEST(RationalExponents, SqrtOfOddExponentsHalves) {
+    auto r = sqrt(Velocity(16.0));
+    static_assert(std::is_same_v<decltype(r)::DimensionType, Dimensions<0,1,-1,0,0,0,0,2>>);
+    EXPECT_DOUBLE_EQ(r.value, 4.0);
+    Velocity back = r * r;
+    EXPECT_DOUBLE_EQ(back.value, 16.0);
+}
+
+TEST(RationalExponents, DimArithmeticStaysInLowestTerms) {
+    using Half  = DimHalve<Dimensions<0,1,0>>::type;          // m^(1/2)
+    using Third = DimPow<Dimensions<0,1,0>, 1, 3>::type;      // m^(1/3)
+    using Sum   = DimAdd<Half, Third>::type;
+    static_assert(std::is_same_v<Sum, Dimensions<0,5,0,0,0,0,0,6>>);
+    static_assert(std::is_same_v<DimAdd<Half, Half>::type, Dimensions<0,1,0>>);
+    static_assert(std::is_same_v<DimSub<Sum, Third>::type, Half>);
+    static_assert(std::is_same_v<DimPow<Dimensions<0,2,-2>, 3, 2>::type, Dimensions<0,3,-3>>);
+    static_assert(std::is_same_v<DimPow<Dimensions<0,1,0>, 2, -4>::type, Dimensions<0,-1,0,0,0,0,0,2>>);
+}
+
+TEST(RationalExponents, RationalPow) {
+    Volume v = pow<3, 2>(Area(4.0));
+    EXPECT_DOUBLE_EQ(v.value, 8.0);
+    EXPECT_EQ((pow<2, 4>(Velocity(9.0))), sqrt(Velocity(9.0)));
+    EXPECT_DOUBLE_EQ((pow<-1, 2>(Area(4.0)).value), 0.5);
+    static_assert(std::is_same_v<decltype(pow<-1, 2>(Area(4.0))), Quantity<Dimensions<0,-1,0>>>);
+    auto f = pow<2, 5>(Length(32.0));
+    static_assert(std::is_same_v<decltype(f)::DimensionType, Dimensions<0,2,0,0,0,0,0,5>>);
+    EXPECT_NEAR(f.value, 4.0, 1e-12);
+    static_assert(pow<6, 3>(3.0_m).value == 9.0);
+}
+
+TEST(RationalExponents, CbrtRoundTrips) {
+    Length side = cbrt(Volume(27.0));
+    EXPECT_DOUBLE_EQ(side.value, 3.0);
+    auto c = cbrt(Length(8.0));
+    EXPECT_DOUBLE_EQ(c.value, 2.0);
+    Length back = c * c * c;
+    EXPECT_DOUBLE_EQ(back.value, 8.0);
+}
+
+TEST(RationalExponents, IntegerFixedPointAndPackReps) {
+    EXPECT_EQ(cbrt(RebindRep<Volume, std::int64_t>(27)).value, 3);
+    EXPECT_EQ((pow<1, 3>(LengthI(27)).value), 3);
+    EXPECT_EQ((pow<1, 4>(LengthI(16)).value), 2);
+    EXPECT_EQ((pow<2, 3>(LengthI(27)).value), 9);
+
+    using LengthX = RebindRep<Length, Fixed16>;
+    EXPECT_EQ(cbrt(LengthX(Fixed16(27))).value, Fixed16(3));
+    EXPECT_EQ((pow<1, 4>(LengthX(Fixed16(16))).value), Fixed16(2));
+    static_assert(std::is_same_v<decltype(cbrt(LengthX(Fixed16(8))))::RepType, Fixed16>);
+
+    using P = simd::Pack<double, 2>;
+    auto pack = P(0.0);
+    pack.set(0, 27.0);
+    pack.set(1, 8.0);
+    auto roots = cbrt(Quantity<Volume::DimensionType, P>(pack));
+    static_assert(std::is_same_v<decltype(roots), QuantityPack<Length::DimensionType, 2>>);
+    EXPECT_DOUBLE_EQ(roots.value[0], 3.0);
+    EXPECT_DOUBLE_EQ(roots.value[1], 2.0);
+    EXPECT_DOUBLE_EQ((pow<1, 4>(Quantity<Length::DimensionType, P>(P(16.0))).value[1]), 2.0);
+}
+
+TEST(RationalExponents, StreamShowsFractions) {
+    std::ostringstream os;
+    os << sqrt(Velocity(4.0));
+    EXPECT_EQ(os.str(), "2 [m^(1/2)\xc2\xb7s^(-1/2)]");
+    os.str("");
+    os << sqrt(Length(9.0)) * pow<3, 2>(Time(1.0));   // den 2 overall, time exponent 3/2
+    EXPECT_EQ(os.str(), "3 [m^(1/2)\xc2\xb7s^(3/2)]");
+}
+
+TEST(RationalExponents, VectorRootsFuseOrFallBack) {
+    QuantityVector<Velocity::DimensionType> v;
+    for (int i = 0; i < 19; ++i) v.push_back(Velocity(double(i * i)));
+    QuantityVector r = eval(sqrt(v));
+    auto third = pow<1, 3>(v);
+    static_assert(!decltype(third)::vectorizable);
+    static_assert(decltype(sqrt(v))::vectorizable);
+    QuantityVector c = eval(third);
+    for (int i = 0; i < 19; ++i) {
+        EXPECT_DOUBLE_EQ(r[i].value, double(i));
+        EXPECT_NEAR(c[i].value, std::cbrt(double(i * i)), 1e-12);
+    }
+}
+
+// =============================================================================
+// PackedDimensions — Dims<Code>: one 64-bit template argument per dimension
+// =============================================================================
+
+TEST(PackedDimensions, AliasEncodesOneWord) {
+    static_assert(std::is_same_v<Dimensions<1,2,-2>, Dims<Dimensions<1,2,-2>::code>>);
+    static_assert(Dimensions<0,0,0>::code == 0);
+    static_assert(Dimensions<0,1,0>::code == 0x100);
+    static_assert(Dimensions<0,0,-1>::code == 0xff0000);
+    static_assert((Dimensions<0,1,-1,0,0,0,0,2>::code >> 56) == 1);   // denominator − 1
+    EXPECT_EQ(Energy::DimensionType::time, -2);
+    EXPECT_EQ(Energy::DimensionType::den,   1);
+}
+
+TEST(PackedDimensions, AliasReducesToLowestTerms) {
+    static_assert(std::is_same_v<Dimensions<0,2,0,0,0,0,0,2>, Dimensions<0,1,0>>);
+    static_assert(std::is_same_v<Dimensions<0,-1,0,0,0,0,0,-2>, Dimensions<0,1,0,0,0,0,0,2>>);
+    static_assert(std::is_same_v<Dimensions<0,0,0,0,0,0,0,7>, Dimensions<0,0,0>>);
+}
+
+TEST(PackedDimensions, FullExponentRangeRoundTrips) {
+    using D = Dimensions<127,-128,1,-1,64,-64,0>;
+    EXPECT_EQ(D::mass,       127);
+    EXPECT_EQ(D::length,    -128);
+    EXPECT_EQ(D::time,         1);
+    EXPECT_EQ(D::current,     -1);
+    EXPECT_EQ(D::temp,        64);
+    EXPECT_EQ(D::amount,     -64);
+    EXPECT_EQ(D::luminosity,   0);
+    static_assert(std::is_same_v<DimSub<DimAdd<D, Dimensions<0,1,0>>::type, Dimensions<0,1,0>>::type, D>);
+    using R = Dimensions<1,0,0,0,0,0,0,256>;
+    EXPECT_EQ(R::den, 256);
+}
+
+TEST(PackedDimensions, BytewiseFastPathMatchesGeneralPath) {
+    constexpr bool agree = [] {
+        const int v[] = {-128, -100, -64, -2, -1, 0, 1, 2, 63, 64, 100, 127};
+        for (int a : v)
+            for (int b : v)
+                for (int sign : {1, -1}) {
+                    const detail::Exponents x{{a, b, a, 0, b, a, b, b, a, 0, a, b, 0, a, b}, 1},
+                                            y{{b, a, 1, b, 0, -1, a, a, -1, b, 0, a, b, 1, a}, 1};
+                    bool in_range = true;
+                    for (int i = 0; i < detail::kBaseDims; ++i)
+                        in_range = in_range && x.e[i] + sign * y.e[i] >= -128 && x.e[i] + sign * y.e[i] <= 127;
+                    if (!in_range) continue;
+                    const detail::DimCodes fast = detail::combine_codes(detail::encode(x), detail::encode(y), sign);
+                    const detail::DimCodes slow = detail::encode(detail::combine(x, y, sign));
+                    if (fast.si != slow.si || fast.ext != slow.ext) return false;
+                }
+        return true;
+    }();
+    static_assert(agree);
+}
+
+TEST(PackedDimensions, SymbolsCarryOneArgument) {
+    // The mangled type name holds the packed codes, not eight exponents
+    const std::string name = typeid(Energy).name();
+    EXPECT_EQ(name.find("Dimensions"), std::string::npos);
+    EXPECT_NE(name.find("Dims"), std::string::npos);
+}
+
+// =============================================================================
+// ExtensionDimensions — angle, information, count and user-defined base dimensions
+// =============================================================================
+
+template <> struct BaseDimension<3> { static constexpr const char* symbol = "px"; };
+
+TEST(ExtensionDimensions, DistinctFromDimensionless) {
+    static_assert(!std::is_same_v<Angle, Quantity<Dimensions<0,0,0>>>);
+    static_assert(!std::is_same_v<Angle, Information>);
+    static_assert(!std::is_same_v<EventRate, Frequency>);
+    static_assert(std::is_same_v<decltype(1.0_rad / 1.0_s), AngularVelocity>);
+    static_assert(std::is_same_v<decltype(1.0_B / 1.0_s), DataRate>);
+    static_assert(std::is_same_v<decltype(Count(3.0) / 1.0_s), EventRate>);
+    static_assert(std::is_same_v<decltype((1.0_rad / 1.0_s) * 1.0_s), Angle>);
+    static_assert(std::is_same_v<decltype(1.0_rad / 1.0_rad), Quantity<Dimensions<0,0,0>>>);
+}
+
+TEST(ExtensionDimensions, Conversions) {
+    EXPECT_NEAR((60.0_rpm).value, 2.0 * M_PI, 1e-12);
+    EXPECT_NEAR((180.0_deg).value, M_PI, 1e-15);
+    EXPECT_DOUBLE_EQ((1.0_kB).value, 8000.0);
+    EXPECT_DOUBLE_EQ((1.0_KiB).value, 8192.0);
+    DataRate r = 1.0_GB / 8.0_s;
+    EXPECT_DOUBLE_EQ(r.value, (1.0_Gbps).value);
+    Time t = 100.0_MB / 100.0_Mbps;
+    EXPECT_DOUBLE_EQ(t.value, 8.0);
+}
+
+TEST(ExtensionDimensions, ArithmeticGeneralizes) {
+    auto w2 = pow<2>(AngularVelocity(3.0));
+    static_assert(decltype(w2)::DimensionType::base(0) == 2);
+    static_assert(decltype(w2)::DimensionType::time == -2);
+    auto h = sqrt(Angle(4.0));
+    static_assert(std::is_same_v<decltype(h)::DimensionType, BaseDim<0, 1, 2>>);
+    EXPECT_DOUBLE_EQ(h.value, 2.0);
+    Angle back = h * h;
+    EXPECT_DOUBLE_EQ(back.value, 4.0);
+    static_assert(std::is_same_v<DimAdd<BaseDim<5>, BaseDim<5>>::type, BaseDim<5, 2>>);
+    static_assert(std::is_same_v<DimSub<BaseDim<7, -3>, BaseDim<7, -3>>::type, Dimensions<0,0,0>>);
+}
+
+TEST(ExtensionDimensions, StreamNamesSlots) {
+    std::ostringstream os;
+    os << 3.0_rad / 1.0_s;
+    EXPECT_EQ(os.str(), "3 [s^-1\xc2\xb7rad]");
+    os.str("");
+    os << Quantity<BaseDim<3>>(1920.0) / 1.0_m << ' ' << Quantity<BaseDim<4, -1>>(2.0) << ' ' << Count(5.0);
+    EXPECT_EQ(os.str(), "1920 [m^-1\xc2\xb7px] 2 [base4^-1] 5 [count]");
+}
+
+// =============================================================================
+// ScaledQuantity — non-SI units with exact compile-time scales
+// =============================================================================
+
+TEST(ScaledQuantity, ExactScales) {
+    static_assert(std::is_same_v<scale::ft, std::ratio<381, 1250>>);
+    static_assert(std::is_same_v<scale::mi, std::ratio<201168, 125>>);
+    static_assert(std::is_same_v<std::ratio_divide<scale::ft, scale::in>::type, std::ratio<12>>);
+    EXPECT_DOUBLE_EQ(Feet(1.0).si().value, (1.0_ft).value);
+    EXPECT_DOUBLE_EQ(Miles(1.0).si().value, (1.0_mi).value);
+    EXPECT_DOUBLE_EQ(Pounds(1.0).si().value, (1.0_lb).value);
+    EXPECT_NEAR(Psi(1.0).si().value, (1.0_psi).value, 1e-9);
+}
+
+TEST(ScaledQuantity, ConversionsFoldToOneMultiply) {
+    // ft → in is an exact integer factor; the chain never visits metres
+    Inches i = Feet(2.0);
+    EXPECT_EQ(i.value, 24.0);
+    Feet f = Miles(1.0);
+    EXPECT_EQ(f.value, 5280.0);
+    Length m = Inches(Feet(10.0));
+    EXPECT_DOUBLE_EQ(m.value, 3.048);
+    static_assert(Feet(Yards(1.0)).value == 3.0);
+    static_assert(unit_cast<scale::in>(Feet(1.0)).value == 12.0);
+    EXPECT_DOUBLE_EQ(unit_cast<scale::ft>(3.048_m).value, 10.0);
+    EXPECT_DOUBLE_EQ(Feet(3.048_m).value, 10.0);
+}
+
+TEST(ScaledQuantity, ArithmeticTracksScale) {
+    auto sum = Feet(1.0) + Inches(6.0);
+    static_assert(std::is_same_v<decltype(sum)::ScaleType, scale::in>);
+    EXPECT_EQ(sum.value, 18.0);
+    EXPECT_EQ((Feet(3.0) - Feet(1.0)).value, 2.0);
+
+    auto area = Feet(3.0) * Feet(4.0);
+    static_assert(std::is_same_v<decltype(area)::DimensionType, Area::DimensionType>);
+    static_assert(std::is_same_v<decltype(area)::ScaleType, std::ratio_multiply<scale::ft, scale::ft>>);
+    EXPECT_EQ(area.value, 12.0);
+    Area a = area;
+    EXPECT_DOUBLE_EQ(a.value, 12.0 * 0.3048 * 0.3048);
+
+    // mph: miles per hour, converted to SI once
+    Velocity v = Miles(60.0) / Hours(1.0);
+    EXPECT_DOUBLE_EQ(v.value, 60.0 * 1609.344 / 3600.0);
+
+    // An SI operand has scale 1
+    auto w = PoundsForce(10.0) * 2.0_m;
+    static_assert(std::is_same_v<decltype(w)::ScaleType, scale::lbf>);
+    Energy e = w;
+    EXPECT_NEAR(e.value, 10.0 * 4.4482216152605 * 2.0, 1e-12);
+    Length l = 1.0_m + Feet(1.0);
+    EXPECT_DOUBLE_EQ(l.value, 1.3048);
+
+    EXPECT_EQ((Feet(2.0) * 3.0).value, 6.0);
+    EXPECT_EQ((-Feet(2.0)).value, -2.0);
+}
+
+TEST(ScaledQuantity, IntegerRepsRescaleWithoutTruncatingTheFactor) {
+    using InI = ScaledQuantity<Length::DimensionType, scale::in, long long>;
+    using FtI = ScaledQuantity<Length::DimensionType, scale::ft, long long>;
+    using MiI = ScaledQuantity<Length::DimensionType, scale::mi, long long>;
+    EXPECT_EQ(FtI(InI(120)).value, 10);
+    EXPECT_EQ(MiI(FtI(10560)).value, 2);
+    EXPECT_EQ(FtI(10).si().value, 3);                          // 3.048 m, truncated
+    EXPECT_EQ(unit_cast<scale::ft>(InI(30)).value, 2);         // 2.5 ft, truncated
+    InI i = FtI(3);                                             // × 12: exact, so implicit
+    EXPECT_EQ(i.value, 36);
+    EXPECT_TRUE(FtI(1) == InI(12));
+
+    auto half = FtI(7) * 0.5;
+    static_assert(std::is_same_v<decltype(half)::RepType, double>);
+    EXPECT_DOUBLE_EQ(half.value, 3.5);
+}
+
+TEST(ScaledQuantity, LossyConversionsAreExplicit) {
+    using InI = ScaledQuantity<Length::DimensionType, scale::in, long long>;
+    using FtI = ScaledQuantity<Length::DimensionType, scale::ft, long long>;
+    using MiI = ScaledQuantity<Length::DimensionType, scale::mi, long long>;
+    static_assert(std::is_convertible_v<FtI, InI> && std::is_convertible_v<MiI, FtI>);
+    static_assert(!std::is_convertible_v<InI, FtI> && std::is_constructible_v<FtI, InI>);
+    static_assert(!std::is_convertible_v<FtI, RebindRep<Length, long long>>);
+    static_assert(std::is_convertible_v<ScaledQuantity<Length::DimensionType, std::ratio<1000>, long long>,
+                                        RebindRep<Length, long long>>);   // km → m
+    // A change of Rep is explicit, whichever way it goes
+    static_assert(!std::is_convertible_v<Feet, FtI> && std::is_constructible_v<FtI, Feet>);
+    static_assert(!std::is_convertible_v<FtI, Feet> && std::is_constructible_v<Feet, FtI>);
+    // Floating point stays implicit, as for std::chrono
+    static_assert(std::is_convertible_v<Inches, Feet> && std::is_convertible_v<Feet, Length>);
+}
+
+TEST(ScaledQuantity, ComparesAcrossScales) {
+    EXPECT_TRUE(Feet(1.0) == Inches(12.0));
+    EXPECT_TRUE(Yards(1.0) > Feet(2.9));
+    EXPECT_TRUE(Inches(11.0) < Feet(1.0));
+    std::ostringstream os;
+    os << Feet(2.0) << ' ' << (Miles(1.0) / Hours(1.0));
+    EXPECT_EQ(os.str(), "2 [381/1250 \xc2\xb7 m] 1 [1397/3125 \xc2\xb7 m\xc2\xb7s^-1]");
+}
+
+// =============================================================================
+// UnitConvert — bulk conversion of raw readings to SI quantity columns
+// =============================================================================
+
+TEST(UnitConvert, LinearMatchesLiteralExactly) {
+    std::vector<double> raw;
+    for (int i = 0; i < 37; ++i) raw.push_back(0.5 * i - 3.0);   // not a multiple of the pack width
+    auto p = convert<unit::psi>(raw);
+    static_assert(std::is_same_v<decltype(p), QuantityVector<Pressure::DimensionType>>);
+    ASSERT_EQ(p.size(), raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        EXPECT_EQ(p[i].value, operator""_psi(static_cast<long double>(raw[i])).value);
+        EXPECT_EQ(convert<unit::ft>(raw)[i].value, operator""_ft(static_cast<long double>(raw[i])).value);
+        EXPECT_EQ(convert<unit::lb>(raw)[i].value, operator""_lb(static_cast<long double>(raw[i])).value);
+    }
+    static_assert(std::is_same_v<unit::kWh::quantity, Energy>);
+    static_assert(unit::km::factor == 1000.0 && unit::m::factor == 1.0);
+}
+
+TEST(UnitConvert, AffineTemperature) {
+    const std::vector<double> raw = {-40.0, 0.0, 32.0, 98.6, 212.0, 451.0, 1000.0, -459.67, 20.0};
+    auto f = convert<unit::degF>(raw);
+    auto c = convert<unit::degC>(raw);
+    for (size_t i = 0; i < raw.size(); ++i) {
+        EXPECT_NEAR(f[i].value, operator""_degF(static_cast<long double>(raw[i])).value, 1e-12);
+        EXPECT_EQ(c[i].value, operator""_degC(static_cast<long double>(raw[i])).value);
+    }
+    EXPECT_NEAR(f[0].value, c[0].value, 1e-12);   // -40 °F == -40 °C
+    EXPECT_NEAR(f[7].value, 0.0, 1e-12);
+}
+
+TEST(UnitConvert, IntoExistingStorage) {
+    const std::vector<double> raw = {1.0, 2.0, 3.0};
+    std::vector<Length> out(3, Length(0.0));
+    convert<unit::km>(raw, out);
+    EXPECT_EQ(out[2].value, 3000.0);
+    convert<unit::m>(raw, out);   // identity: a copy
+    EXPECT_EQ(out[1].value, 2.0);
+    std::vector<Length> wrong(2, Length(0.0));
+    EXPECT_THROW(convert<unit::ft>(raw, wrong), std::invalid_argument);
+    EXPECT_TRUE(convert<unit::bar>(std::span<const double>()).empty());
+}
+
+// =============================================================================
+// UnitStrings — dimension text computed at compile time
+// =============================================================================
+
+TEST(UnitStrings, ComputedAtCompileTime) {
+    static_assert(dim_string_v<Energy::DimensionType> == "kg\xc2\xb7m^2\xc2\xb7s^-2");
+    static_assert(dim_string_v<Velocity::DimensionType> == "m\xc2\xb7s^-1");
+    static_assert(dim_string_v<Dimensions<0,0,0>> == "1");
+    static_assert(dim_string_v<Dimensions<0,1,0,0,0,0,0,2>> == "m^(1/2)");
+    static_assert(dim_string_v<Dimensions<-3,-2,-10,0,0,0,0,1>> == "kg^-3\xc2\xb7m^-2\xc2\xb7s^-10");
+    static_assert(dim_string_v<AngularVelocity::DimensionType> == "s^-1\xc2\xb7rad");
+    static_assert(detail::unit_suffix<Pressure::DimensionType>.view() == " [kg\xc2\xb7m^-1\xc2\xb7s^-2]");
+    static_assert(sizeof(detail::unit_suffix<Length::DimensionType>.chars) == 5);   // " [m]" + NUL
+}
+
+TEST(UnitStrings, StreamWritesSuffix) {
+    std::ostringstream os;
+    os << 9.81_m / (1.0_s * 1.0_s) << ' ' << sqrt(2.0_m) << ' ' << Quantity<Dimensions<0,0,0>>(0.5);
+    EXPECT_EQ(os.str(), "9.81 [m\xc2\xb7s^-2] 1.41421 [m^(1/2)] 0.5 [1]");
+}
+
+// =============================================================================
+// QuantityFormat — to_chars and std::formatter output
+// =============================================================================
+
+namespace {
+    template <typename Q>
+    std::string format_with(Q q, QuantityFormatSpec spec = {}) {
+        char buf[128];
+        auto r = to_chars(buf, buf + sizeof buf, q, spec);
+        EXPECT_EQ(r.ec, std::errc());
+        return std::string(buf, r.ptr);
+    }
+}
+
+TEST(QuantityFormat, ShortestRoundTripByDefault) {
+    EXPECT_EQ(format_with(9.81_m / (1.0_s * 1.0_s)), "9.81 [m\xc2\xb7s^-2]");
+    EXPECT_EQ(format_with(Energy(0.1)), "0.1 [kg\xc2\xb7m^2\xc2\xb7s^-2]");
+    EXPECT_EQ(format_with(1.0_eV), "1.602176634e-19 [kg\xc2\xb7m^2\xc2\xb7s^-2]");
+    EXPECT_EQ(format_with(Quantity<Dimensions<0,0,0>>(0.5)), "0.5 [1]");
+    EXPECT_EQ(format_with(Quantity<Dimensions<0,1,0>, int>(42)), "42 [m]");
+    EXPECT_EQ(format_with(Quantity<Dimensions<0,1,0>, FixedPoint<16>>(1.5)), "1.5 [m]");
+}
+
+TEST(QuantityFormat, PrecisionAndNotation) {
+    EXPECT_EQ(format_with(101325.0_Pa, {'e', 3}), "1.013e+05 [kg\xc2\xb7m^-1\xc2\xb7s^-2]");
+    EXPECT_EQ(format_with(2.0_m / 3.0_s, {'f', 2}), "0.67 [m\xc2\xb7s^-1]");
+    EXPECT_EQ(format_with(300.0_K, {'g', 2}), "3e+02 [K]");
+    EXPECT_EQ(format_with(1.0_m, {'a', -1}), "1p+0 [m]");
+}
+
+TEST(QuantityFormat, ParsesSpecs) {
+    QuantityFormatSpec s;
+    const char* spec = ".12e}";
+    EXPECT_EQ(detail::parse_quantity_spec(spec, spec + 5, s), spec + 4);
+    EXPECT_EQ(s.precision, 12);
+    EXPECT_EQ(s.type, 'e');
+    QuantityFormatSpec empty;
+    const char* none = "}";
+    EXPECT_EQ(detail::parse_quantity_spec(none, none + 1, empty), none);
+    EXPECT_EQ(empty.type, 0);
+    const char* bad[] = {".e}", "x}", ".3q}", "10f}"};
+    for (const char* b : bad) {
+        QuantityFormatSpec t;
+        EXPECT_EQ(detail::parse_quantity_spec(b, b + std::strlen(b), t), nullptr) << b;
+    }
+}
+
+TEST(QuantityFormat, ReportsShortBuffer) {
+    char buf[8];
+    EXPECT_EQ(to_chars(buf, buf + sizeof buf, 9.81_m / 1.0_s).ec, std::errc::value_too_large);   // value fits, unit does not
+    EXPECT_EQ(to_chars(buf, buf + 3, 12345.0_m).ec, std::errc::value_too_large);
+    auto r = to_chars(buf, buf + sizeof buf, 1.0_m);
+    EXPECT_EQ(std::string(buf, r.ptr), "1 [m]");
+}
+
+namespace {
+    // Every spec parse_quantity_spec accepts, at the extremes of Rep, fits
+    // in the buffer std::formatter sizes with max_quantity_chars
+    template <typename Q>
+    void expect_longest_text_fits() {
+        using L = std::numeric_limits<typename Q::RepType>;
+        const QuantityFormatSpec specs[] = {{}, {'f', -1}, {'f', detail::kMaxFormatPrecision},
+                                            {'e', detail::kMaxFormatPrecision}, {'g', detail::kMaxFormatPrecision},
+                                            {'a', detail::kMaxFormatPrecision, true}};
+        std::vector<char> buf(detail::max_quantity_chars<Q>());
+        for (auto x : {L::max(), L::lowest(), L::min(), -L::denorm_min()})
+            for (QuantityFormatSpec spec : specs) {
+                const auto r = to_chars(buf.data(), buf.data() + buf.size(), Q(x), spec);
+                EXPECT_EQ(r.ec, std::errc()) << x << ' ' << spec.type << spec.precision;
+            }
+    }
+}
+
+TEST(QuantityFormat, LongestAcceptedSpecFitsTheFormatterBuffer) {
+    QuantityFormatSpec s;
+    const char* widest = ".1000f}";
+    EXPECT_EQ(detail::parse_quantity_spec(widest, widest + 7, s), widest + 6);
+    const char* wider = ".1001f}";
+    EXPECT_EQ(detail::parse_quantity_spec(wider, wider + 7, s), nullptr);
+
+    expect_longest_text_fits<Energy>();
+    expect_longest_text_fits<RebindRep<Energy, float>>();
+    expect_longest_text_fits<RebindRep<Energy, long double>>();
+}
+
+#if defined(ENGINE_REQUIRE_STD_FORMAT) && !defined(__cpp_lib_format)
+#error "ENGINE_REQUIRE_STD_FORMAT is set but the standard library has no <format>"
+#endif
+
+#if defined(__cpp_lib_format)
+TEST(QuantityFormat, StdFormat) {
+    EXPECT_EQ(std::format("{}", 9.81_m), "9.81 [m]");
+    EXPECT_EQ(std::format("{:.2f}", 2.0_m / 3.0_s), "0.67 [m\xc2\xb7s^-1]");
+    EXPECT_EQ(std::format("{:n}", 4.0_W), "4 [W]");
+    EXPECT_EQ(std::format("{:.600f}", 1.0_m), std::format("{:.600f}", 1.0) + " [m]");
+    const Length l = 1.0_m;
+    EXPECT_THROW((void)std::vformat("{:x}", std::make_format_args(l)), std::format_error);
+}
+#endif
+
+// =============================================================================
+// NamedUnits — SI derived-unit symbols resolved per dimension at compile time
+// =============================================================================
+
+TEST(NamedUnits, SymbolsPerDimension) {
+    static_assert(unit_symbol_v<Energy::DimensionType> == "J");
+    static_assert(unit_symbol_v<Force::DimensionType> == "N");
+    static_assert(unit_symbol_v<Pressure::DimensionType> == "Pa");
+    static_assert(unit_symbol_v<Resistance::DimensionType> == "\xce\xa9");
+    static_assert(unit_symbol_v<Frequency::DimensionType> == "Hz");
+    static_assert(unit_symbol_v<CatalyticActivity::DimensionType> == "kat");
+    // No name: base units, identical to dim_string_v
+    static_assert(unit_symbol_v<Velocity::DimensionType> == "m\xc2\xb7s^-1");
+    static_assert(unit_symbol_v<AbsorbedDose::DimensionType> == dim_string_v<AbsorbedDose::DimensionType>);
+    static_assert(unit_symbol_v<Dimensions<0,0,0>> == "1");
+    // Derived by arithmetic, not spelled through the alias
+    static_assert(unit_symbol_v<decltype(1.0_kg * 1.0_m / (1.0_s * 1.0_s))::DimensionType> == "N");
+}
+
+TEST(NamedUnits, StreamAndToChars) {
+    std::ostringstream os;
+    os << named(2.0_kg * 9.81_m / (1.0_s * 1.0_s)) << ' ' << named(3.0_V / 1.5_A) << ' ' << named(10.0_m / 2.0_s);
+    EXPECT_EQ(os.str(), "19.62 [N] 2 [\xce\xa9] 5 [m\xc2\xb7s^-1]");
+    os.str("");
+    os << 5.0_J;   // plain operator<< still prints base units
+    EXPECT_EQ(os.str(), "5 [kg\xc2\xb7m^2\xc2\xb7s^-2]");
+
+    char buf[64];
+    QuantityFormatSpec spec;
+    const char* s = ".2fn";
+    ASSERT_EQ(detail::parse_quantity_spec(s, s + 4, spec), s + 4);
+    EXPECT_TRUE(spec.named);
+    auto r = to_chars(buf, buf + sizeof buf, 101325.0_Pa, spec);
+    EXPECT_EQ(std::string(buf, r.ptr), "101325.00 [Pa]");
+    r = to_chars(buf, buf + sizeof buf, 1.0_kWh, {0, -1, true});
+    EXPECT_EQ(std::string(buf, r.ptr), "3600000 [J]");
+}
+
+// =============================================================================
+// QuantityParse — text to SI quantities through the compile-time symbol table
+// =============================================================================
+
+TEST(QuantityParse, UnitExpressions) {
+    using HeatTransfer   = Quantity<Dimensions<1,0,-3,0,-1>>;
+    using RootLength     = Quantity<Dimensions<0,1,0,0,0,0,0,2>>;
+    using RootLengthTime = Quantity<Dimensions<0,1,4,0,0,0,0,2>>;   // m^(1/2)·s^2
+    using Scalar         = Quantity<Dimensions<0,0,0>>;
+    EXPECT_DOUBLE_EQ(parse_quantity<Acceleration>("9.81 m/s^2").value, 9.81);
+    EXPECT_DOUBLE_EQ(parse_quantity<Energy>("3 kWh").value, 3.0 * 3.6e6);
+    EXPECT_DOUBLE_EQ(parse_quantity<Pressure>("14.7psi").value, (14.7_psi).value);
+    EXPECT_DOUBLE_EQ(parse_quantity<Energy>("2 N m").value, 2.0);
+    EXPECT_DOUBLE_EQ(parse_quantity<Energy>("2 N·m").value, 2.0);
+    EXPECT_DOUBLE_EQ(parse_quantity<Energy>("2 kg * m^2 / s^2").value, 2.0);
+    EXPECT_DOUBLE_EQ(parse_quantity<SpecificHeat>("4186 J/(kg·K)").value, 4186.0);
+    EXPECT_DOUBLE_EQ(parse_quantity<HeatTransfer>("5 W/m^2/K").value, 5.0);
+    EXPECT_DOUBLE_EQ(parse_quantity<Area>("1 ft^2").value, (1.0_ft * 1.0_ft).value);
+    EXPECT_DOUBLE_EQ(parse_quantity<Time>("5 \xc2\xb5s").value, 5e-6);            // µs
+    EXPECT_DOUBLE_EQ(parse_quantity<Resistance>("3 k\xce\xa9").value, 3000.0);     // kΩ
+    EXPECT_DOUBLE_EQ(parse_quantity<DataRate>("100 Mbps").value, (100.0_Mbps).value);
+    EXPECT_DOUBLE_EQ(parse_quantity<Temperature>("72 degF").value, (72.0_degF).value);
+    EXPECT_DOUBLE_EQ(parse_quantity<Temperature>("-40 \xc2\xb0" "C").value, 233.15);
+    EXPECT_DOUBLE_EQ(parse_quantity<RootLength>("4 m^(1/2)").value, 4.0);
+    EXPECT_DOUBLE_EQ(parse_quantity<RootLengthTime>("1 m^(1/2)*s^2").value, 1.0);
+    EXPECT_DOUBLE_EQ(parse_quantity<Frequency>("50 s^-1").value, 50.0);
+
+    const DynQuantity q = parse_quantity("1.5e3 W");
+    EXPECT_TRUE(q.is<Power>());
+    EXPECT_FALSE(q.is<Energy>());
+    EXPECT_DOUBLE_EQ(q.value, 1500.0);
+    EXPECT_TRUE(parse_quantity("7").is<Scalar>());
+}
+
+TEST(QuantityParse, ReadsBackFormattedOutput) {
+    const Energy e = 1.25_kWh;
+    const Velocity v = 3.0_m / 7.0_s;
+    const auto r = sqrt(2.0_m);
+    using RootLength = std::remove_const_t<decltype(r)>;
+    char buf[64];
+    auto w = to_chars(buf, buf + sizeof buf, e);
+    EXPECT_EQ(parse_quantity<Energy>(std::string_view(buf, w.ptr)), e);
+    w = to_chars(buf, buf + sizeof buf, e, {0, -1, true});                          // "[J]"
+    EXPECT_EQ(parse_quantity<Energy>(std::string_view(buf, w.ptr)), e);
+    w = to_chars(buf, buf + sizeof buf, v);
+    EXPECT_EQ(parse_quantity<Velocity>(std::string_view(buf, w.ptr)), v);
+    w = to_chars(buf, buf + sizeof buf, r);                                         // m^(1/2)
+    EXPECT_EQ(parse_quantity<RootLength>(std::string_view(buf, w.ptr)), r);
+    const auto jerk_root = 3.0 * r / (1.0_s * 1.0_s);                               // half then squared exponent
+    using RootJerk = std::remove_const_t<decltype(jerk_root)>;
+    w = to_chars(buf, buf + sizeof buf, jerk_root, {0, -1, true});                  // "[m^(1/2)·s^-2]"
+    EXPECT_EQ(parse_quantity<RootJerk>(std::string_view(buf, w.ptr)), jerk_root);
+    std::ostringstream os;
+    os << named(3.0_V / 1.5_A);
+    EXPECT_EQ(parse_quantity<Resistance>(os.str()).value, 2.0);
+}
+
+TEST(QuantityParse, FromCharsContract) {
+    const std::string_view text = "9.81 m/s^2, 3 kWh";
+    const char* last = text.data() + text.size();
+    Acceleration a(0.0);
+    auto r = parse_quantity(text.data(), last, a);
+    EXPECT_EQ(r.ec, std::errc());
+    EXPECT_EQ(r.ptr, text.data() + 10);                 // stops at the comma
+    EXPECT_DOUBLE_EQ(a.value, 9.81);
+
+    Energy e(-1.0);
+    r = parse_quantity(text.data(), last, e);            // right text, wrong dimension
+    EXPECT_EQ(r.ec, std::errc::argument_out_of_domain);
+    EXPECT_EQ(r.ptr, text.data() + 10);
+    EXPECT_EQ(e.value, -1.0);                            // untouched
+
+    DynQuantity q{};
+    const std::string_view apples = "3 apples";
+    r = parse_quantity(apples.data(), apples.data() + apples.size(), q);
+    EXPECT_EQ(r.ec, std::errc());                        // a dimensionless 3; "apples" is not a unit
+    EXPECT_EQ(r.ptr, apples.data() + 1);
+}
+
+TEST(QuantityParse, RejectsMalformedText) {
+    for (const char* bad : {"", "m", "3xyz", "3 m^", "3 m/", "3 m/xyz", "3 [m", "3 [m·]", "3 degC m",
+                            "3 m degF", "3 degC^2", "3 [(degC)]", "3 m^1234", "3 m^(1/0)", "3abcdefghij"}) {
+        DynQuantity q{};
+        const auto r = parse_quantity(bad, bad + std::strlen(bad), q);
+        EXPECT_EQ(r.ec, std::errc::invalid_argument) << bad;
+        EXPECT_EQ(r.ptr, bad) << bad;
+    }
+    DynQuantity q{};
+    const char* big = "1 m^100·m^100";
+    EXPECT_EQ(parse_quantity(big, big + std::strlen(big), q).ec, std::errc::result_out_of_range);
+    EXPECT_THROW(parse_quantity<Length>("3 s"), std::invalid_argument);
+    EXPECT_THROW(parse_quantity<Length>("3 m extra"), std::invalid_argument);
+    EXPECT_THROW(parse_quantity(big), std::out_of_range);
+    EXPECT_EQ(parse_quantity<Length>("3 m  ").value, 3.0);
+}
+
+// =============================================================================
+// DynQuantity — run-time dimensions on packed codes
+// =============================================================================
+
+TEST(DynQuantity, ArithmeticTracksDimensions) {
+    using InverseSpeed = Quantity<Dimensions<0,-1,1>>;
+    const DynQuantity m = 2.0_kg, v = 3.0_m / 1.0_s;
+    const DynQuantity e = 0.5 * m * v * v;
+    EXPECT_TRUE(e.is<Energy>());
+    EXPECT_FALSE(e.is<Power>());
+    EXPECT_DOUBLE_EQ(e.as<Energy>().value, 9.0);
+    EXPECT_TRUE((e / 3.0_s).is<Power>());                       // typed operand on one side
+    EXPECT_TRUE((1.0 / (DynQuantity(1.0_m) / 2.0_s)).is<InverseSpeed>());
+    EXPECT_DOUBLE_EQ((e + 1.0_J - DynQuantity(4.0_J)).value, 6.0);
+    EXPECT_TRUE((-e).is<Energy>());
+
+    // Extension slots and fractional exponents take the same operators
+    const DynQuantity w = DynQuantity(6.0_rad) / 2.0_s;
+    EXPECT_TRUE(w.is<AngularVelocity>());
+    const DynQuantity root = sqrt(4.0_m);
+    EXPECT_TRUE((root * root).is<Length>());
+    EXPECT_DOUBLE_EQ((root * root).value, 4.0);
+
+    // Typed arithmetic is unchanged: mixing dimensions is still a compile error
+    static_assert(!Addable<Length, Time>);
+    static_assert(Addable<Length, DynQuantity>);
+}
+
+TEST(DynQuantity, MismatchesThrow) {
+    const DynQuantity e = 1.0_J, p = 1.0_W;
+    EXPECT_THROW((void)(e + p), std::invalid_argument);
+    EXPECT_THROW((void)(e - 1.0_s), std::invalid_argument);
+    EXPECT_THROW((void)(e < p), std::invalid_argument);
+    EXPECT_THROW((void)e.as<Power>(), std::invalid_argument);
+    EXPECT_FALSE(e == p);                                       // unequal, not an error
+    EXPECT_TRUE(e == 1.0_J);
+    EXPECT_TRUE(e < 2.0_J);
+    try {
+        (void)(e + p);
+    } catch (const std::invalid_argument& x) {
+        EXPECT_NE(std::string(x.what()).find("[kg\xc2\xb7m^2\xc2\xb7s^-2] and [kg\xc2\xb7m^2\xc2\xb7s^-3]"), std::string::npos);
+    }
+    DynQuantity big = 1.0_m;
+    for (int i = 0; i < 6; ++i) big = big * big;                // m^64
+    EXPECT_THROW((void)(big * big), std::out_of_range);       // m^128
+}
+
+TEST(DynQuantity, PrintsLikeTypedQuantities) {
+    using Scalar = Quantity<Dimensions<0,0,0>>;
+    std::ostringstream dyn, typed;
+    dyn << DynQuantity(9.81_m / (1.0_s * 1.0_s)) << ' ' << DynQuantity(3.0_bit / 1.0_s) << ' ' << DynQuantity(Scalar(2.0));
+    typed << 9.81_m / (1.0_s * 1.0_s) << ' ' << 3.0_bit / 1.0_s << ' ' << Scalar(2.0);
+    EXPECT_EQ(dyn.str(), typed.str());
+    EXPECT_EQ(detail::dim_string(detail::dim_codes_v<Energy::DimensionType>), dim_string_v<Energy::DimensionType>);
+    EXPECT_TRUE(parse_quantity("3 kWh").is<Energy>());          // parse_quantity's run-time result
+}
+
+// =============================================================================
+// QuantityReduce — typed, compensated and parallel reductions
+// =============================================================================
+
+TEST(QuantityReduce, ResultsAreTyped) {
+    const std::vector<Energy> e{1.0_J, 2.0_J, 3.0_J, 6.0_J};
+    const std::vector<Force>  f{1.0_N, 2.0_N, 3.0_N, 4.0_N};
+    const std::vector<Length> x{4.0_m, 3.0_m, 2.0_m, 1.0_m};
+    using EnergySquared = Quantity<DimScale<Energy::DimensionType, 2>::type>;
+    static_assert(std::is_same_v<decltype(sum(e)), Energy>);
+    static_assert(std::is_same_v<decltype(mean(e)), Energy>);
+    static_assert(std::is_same_v<decltype(dot(f, x)), Energy>);
+    static_assert(std::is_same_v<decltype(variance(e)), EnergySquared>);
+    static_assert(std::is_same_v<decltype(stddev(e)), Energy>);
+    EXPECT_EQ(sum(e), 12.0_J);
+    EXPECT_EQ(mean(e), 3.0_J);
+    EXPECT_EQ(min(e), 1.0_J);
+    EXPECT_EQ(max(e), 6.0_J);
+    EXPECT_EQ(dot(f, x), 20.0_J);
+    EXPECT_DOUBLE_EQ(variance(e).value, 3.5);
+    EXPECT_DOUBLE_EQ(stddev(e).value, std::sqrt(3.5));
+    EXPECT_EQ(sum(std::vector<Energy>{}), 0.0_J);
+
+    // Vectors, spans over raw storage and unevaluated expressions reduce alike
+    QuantityVector<Mass::DimensionType>     m(100, 2.0_kg);
+    QuantityVector<Velocity::DimensionType> v(100, 3.0_m / 1.0_s);
+    static_assert(std::is_same_v<decltype(sum(0.5 * m * pow<2>(v))), Energy>);
+    EXPECT_DOUBLE_EQ(sum(0.5 * m * pow<2>(v)).value, 900.0);
+    std::vector<double> raw{5.0, -1.0, 2.0};
+    EXPECT_EQ(min(as_quantities<Time::DimensionType>(std::span(raw))), -1.0_s);
+}
+
+TEST(QuantityReduce, CompensatedSumsStayAccurate) {
+    // One large value and a million that each round away against it
+    std::vector<Energy> e(1'000'001, 1e-16_J);
+    e[0] = 1.0_J;
+    double naive = 0;
+    for (Energy x : e) naive += x.value;
+    EXPECT_EQ(naive, 1.0);
+    const double exact = 1.0 + 1e-10;
+    EXPECT_NEAR(sum(e).value, exact, 1e-14);                     // naive is 1e-10 off
+    EXPECT_NEAR(sum(e, {.summation = Summation::kahan}).value, exact, 1e-15);
+
+    // Cancellation: Neumaier's step keeps the small term Kahan's would lose
+    const std::vector<Energy> c{1.0_J, 1e100_J, 1.0_J, -1e100_J};
+    EXPECT_EQ(sum(c, {.summation = Summation::kahan}), 2.0_J);
+}
+
+TEST(QuantityReduce, ThreadsSplitTheRange) {
+    std::vector<Length> x;
+    for (int i = 0; i < 100'003; ++i) x.push_back(Length(std::sin(0.001 * i) * (1 + i % 7)));
+    const ReduceOptions serial{}, threaded{.threads = 4, .grain = 1000};
+    const ReduceOptions kahan4{.summation = Summation::kahan, .threads = 4, .grain = 1000};
+    EXPECT_NEAR(sum(x, threaded).value, sum(x, serial).value, 1e-9);
+    EXPECT_NEAR(sum(x, kahan4).value, sum(x, {.summation = Summation::kahan}).value, 1e-12);
+    EXPECT_EQ(min(x, threaded), min(x));
+    EXPECT_EQ(max(x, threaded), max(x));
+    EXPECT_NEAR(variance(x, threaded).value, variance(x).value, 1e-9);
+    EXPECT_NEAR(dot(x, x, kahan4).value, dot(x, x).value, 1e-6);
+    EXPECT_EQ(sum(x, {.threads = 0}), sum(x, {.threads = 0}));   // one per hardware thread
+}
+
+TEST(QuantityReduce, NaNAndEmptyRanges) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<Time> t{Time(nan), 3.0_s, Time(nan), -2.0_s, Time(nan), Time(nan), Time(nan), 7.0_s, Time(nan)};
+    EXPECT_EQ(min(t), -2.0_s);
+    EXPECT_EQ(max(t), 7.0_s);
+    EXPECT_TRUE(std::isnan(min(std::vector<Time>(20, Time(nan))).value));
+    const double inf = std::numeric_limits<double>::infinity();
+    EXPECT_EQ(max(std::vector<Time>{Time(nan), Time(inf)}), Time(inf));
+    EXPECT_THROW((void)min(std::vector<Time>{}), std::invalid_argument);
+    EXPECT_THROW((void)mean(std::vector<Time>{}), std::invalid_argument);
+    EXPECT_THROW((void)variance(std::vector<Time>{}), std::invalid_argument);
+    EXPECT_THROW((void)dot(t, std::vector<Time>(3, 1.0_s)), std::invalid_argument);
+}
+
+// =============================================================================
+// QuantityFilter — threshold selection vectors and bitmaps
+// =============================================================================
+
+namespace {
+    // Reference: indices where the scalar comparison holds
+    template <typename Q, typename Cmp>
+    std::vector<std::uint32_t> scalar_select(const std::vector<Q>& col, Cmp cmp, Q t) {
+        std::vector<std::uint32_t> r;
+        for (size_t i = 0; i < col.size(); ++i)
+            if (cmp(col[i], t)) r.push_back(std::uint32_t(i));
+        return r;
+    }
+
+    template <typename C, typename T>
+    concept Selectable = requires(const C& c, T t) { select_bitmap(c, std::less<>{}, t); };
+}
+
+TEST(QuantityFilter, KernelsMatchScalarComparisons) {
+    // 203 elements: three full words and a partial one, with NaN and ties
+    std::vector<Temperature> t;
+    for (int i = 0; i < 203; ++i) t.push_back(Temperature(300.0 + double((i * 37) % 101)));
+    t[5] = t[130] = Temperature(std::numeric_limits<double>::quiet_NaN());
+    const Temperature limit = 350.0_K;
+    auto check = [&](auto cmp) {
+        const auto expected = scalar_select(t, cmp, limit);
+        EXPECT_EQ(select_indices(t, cmp, limit), expected);
+        std::vector<std::uint32_t> out(t.size());
+        const size_t n = select_indices(t, cmp, limit, std::span(out));
+        out.resize(n);
+        EXPECT_EQ(out, expected);
+        const auto bits = select_bitmap(t, cmp, limit);
+        ASSERT_EQ(bits.size(), bitmap_words(t.size()));
+        EXPECT_EQ(bits.back() >> (t.size() % 64), 0u);     // no bits past the end
+        EXPECT_EQ(indices_of(bits), expected);
+    };
+    check(std::less<>{});
+    check(std::less_equal<>{});
+    check(std::greater<>{});
+    check(std::greater_equal<>{});
+    check(std::equal_to<>{});
+    check(std::not_equal_to<>{});                          // includes the NaNs
+    check([](Temperature x, Temperature y) { return abs(x - y) < 5.0_K; });   // scalar fallback
+}
+
+TEST(QuantityFilter, ColumnsAndThresholdsAreTyped) {
+    QuantityVector<Pressure::DimensionType> p(100, 2.0_atm);
+    p[17] = p[99] = 0.5_atm;
+    EXPECT_EQ(select_indices(p, std::less<>{}, 1.0_atm), (std::vector<std::uint32_t>{17, 99}));
+    EXPECT_EQ(select_indices(p * 2.0, std::less<>{}, 1.5_atm), (std::vector<std::uint32_t>{17, 99}));
+    EXPECT_TRUE(select_indices(std::vector<Pressure>{}, std::less<>{}, 1.0_atm).empty());
+    static_assert(Selectable<QuantityVector<Pressure::DimensionType>, Pressure>);
+    static_assert(!Selectable<QuantityVector<Pressure::DimensionType>, Temperature>);
+    std::vector<std::uint32_t> small(3);
+    EXPECT_THROW((void)select_indices(p, std::less<>{}, 1.0_atm, std::span(small)), std::invalid_argument);
+    std::vector<std::uint64_t> words(1);
+    EXPECT_THROW(select_bitmap(p, std::less<>{}, 1.0_atm, std::span(words)), std::invalid_argument);
+}
+
+TEST(QuantityFilter, IndexLimitsMatchBetweenOverloads) {
+    // Columns up to 2^32 − 1 elements are accepted by both select_indices
+    // overloads; their bitmap has 2^26 words, whose last bit is index 2^32 − 1
+    const std::size_t longest = std::numeric_limits<std::uint32_t>::max();
+    EXPECT_NO_THROW(detail::check_index_range(longest));
+    EXPECT_THROW(detail::check_index_range(longest + 1), std::length_error);
+    EXPECT_EQ(bitmap_words(longest), std::size_t(1) << 26);
+    EXPECT_NO_THROW(detail::check_bitmap_range(bitmap_words(longest)));
+    EXPECT_THROW(detail::check_bitmap_range(bitmap_words(longest) + 1), std::length_error);
+}
+
+// =============================================================================
+// QuantitySort — LSD radix sort, keys only and with payloads
+// =============================================================================
+
+namespace {
+    // Mixed signs and magnitudes, subnormals, zeros of both signs, infinities
+    template <typename Q>
+    std::vector<Q> awkward_values(size_t n) {
+        using T = typename Q::RepType;
+        std::vector<Q> v;
+        std::uint64_t state = 7;
+        for (size_t i = 0; i < n; ++i) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            const double u = double(state >> 11) * 0x1.0p-53;
+            v.push_back(Q(T((u - 0.5) * std::pow(10.0, double(int(state % 41) - 20)))));
+        }
+        const T specials[] = {T(0), -T(0), std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+                              std::numeric_limits<T>::denorm_min(), -std::numeric_limits<T>::denorm_min(),
+                              std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest()};
+        for (size_t i = 0; i < std::size(specials) && i < n; ++i) v[i * 13 % n] = Q(specials[i]);
+        return v;
+    }
+}
+
+TEST(QuantitySort, MatchesOperatorSpaceship) {
+    auto t = awkward_values<Time>(10'007);
+    auto expected = t;
+    std::stable_sort(expected.begin(), expected.end());
+    radix_sort(t);
+    ASSERT_EQ(t.size(), expected.size());
+    for (size_t i = 0; i < t.size(); ++i) EXPECT_EQ(t[i], expected[i]) << i;
+
+    auto f = awkward_values<RebindRep<Energy, float>>(3'001);
+    auto expected_f = f;
+    std::stable_sort(expected_f.begin(), expected_f.end());
+    radix_sort(std::span(f));
+    EXPECT_TRUE(std::equal(f.begin(), f.end(), expected_f.begin()));
+
+    QuantityVector<Length::DimensionType> x{3.0_m, -1.0_m, 2.0_m};
+    radix_sort(x);
+    EXPECT_EQ(x[0], -1.0_m);
+    EXPECT_EQ(x[2], 3.0_m);
+    static_assert(!RadixSortable<const std::vector<Time>>);
+    static_assert(!RadixSortable<std::vector<double>>);
+}
+
+TEST(QuantitySort, ZerosKeepTheirOrderAndNaNGoesLast) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<Time> t{Time(nan), 0.0_s, Time(-0.0), 1.0_s, Time(-nan), Time(-0.0), -1.0_s, 0.0_s};
+    std::vector<int>  id{0, 1, 2, 3, 4, 5, 6, 7};
+    radix_sort(t, id);
+    EXPECT_EQ(id, (std::vector<int>{6, 1, 2, 5, 7, 3, 0, 4}));  // stable; ±0 equal, NaN unordered
+    EXPECT_TRUE(std::signbit(t[2].value));                      // values are moved, not rewritten
+    EXPECT_TRUE(std::isnan(t[6].value) && std::isnan(t[7].value));
+}
+
+TEST(QuantitySort, PayloadsFollowTheirKeys) {
+    struct Row { std::uint32_t entity; float weight; };
+    auto e = awkward_values<Energy>(5'000);
+    std::vector<Row> rows;
+    for (size_t i = 0; i < e.size(); ++i) rows.push_back({std::uint32_t(i), float(i) * 0.5f});
+    const auto original = e;
+    radix_sort(e, rows);
+    EXPECT_TRUE(std::is_sorted(e.begin(), e.end()));
+    for (size_t i = 0; i < e.size(); ++i) {
+        EXPECT_EQ(e[i], original[rows[i].entity]);
+        EXPECT_EQ(rows[i].weight, float(rows[i].entity) * 0.5f);
+    }
+    std::vector<int> short_ids(3);
+    EXPECT_THROW(radix_sort(e, short_ids), std::invalid_argument);
+}
+
+TEST(QuantitySort, ThreadsGiveTheSameOrder) {
+    auto serial = awkward_values<Time>(100'003);
+    serial[500] = serial[90'000] = Time(std::numeric_limits<double>::quiet_NaN());
+    auto threaded = serial;
+    std::vector<std::uint32_t> ids_serial(serial.size()), ids_threaded(serial.size());
+    std::iota(ids_serial.begin(), ids_serial.end(), 0u);
+    ids_threaded = ids_serial;
+    radix_sort(serial, ids_serial);
+    radix_sort(threaded, ids_threaded, {.threads = 4, .grain = 1000});
+    EXPECT_EQ(ids_threaded, ids_serial);
+    auto keys_only = awkward_values<Time>(100'003);
+    radix_sort(keys_only, {.threads = 3, .grain = 1000});
+    EXPECT_TRUE(std::is_sorted(keys_only.begin(), keys_only.end()));
+}